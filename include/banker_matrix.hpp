@@ -0,0 +1,55 @@
+// ============================================
+// FILE: banker_matrix.hpp
+// DESCRIPTION: Flat structure-of-arrays matrices for the Banker's safety search
+// ============================================
+
+#ifndef BANKER_MATRIX_HPP
+#define BANKER_MATRIX_HPP
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Allocation and need are stored one column per resource, each column a
+// single 64-byte aligned array padded to a multiple of BANKER_LANES jobs.
+// The "can finish" test then compares BANKER_LANES jobs' needs against
+// the available vector at once (AVX2 or SSE2 when the compiler targets
+// them, a branchless scalar loop otherwise).
+const int BANKER_RESOURCES = 4;
+const size_t BANKER_LANES = 8;
+
+class BankerMatrix {
+private:
+    size_t rows;
+    size_t capacity;            // Padded row count currently allocated
+
+    int32_t* allocation[BANKER_RESOURCES];
+    int32_t* need[BANKER_RESOURCES];
+    int32_t* pending;           // -1 while a row is still unfinished, 0 after
+    std::vector<int> jobIds;
+
+    void release();
+
+public:
+    BankerMatrix();
+    ~BankerMatrix();
+
+    BankerMatrix(const BankerMatrix&) = delete;
+    BankerMatrix& operator=(const BankerMatrix&) = delete;
+
+    // Drops all rows but keeps the storage for reuse
+    void clear();
+    void reserve(size_t jobs);
+    void addRow(int jobId, const int alloc[BANKER_RESOURCES], const int needs[BANKER_RESOURCES]);
+
+    size_t size() const { return rows; }
+    int getJobId(size_t row) const { return jobIds[row]; }
+    int getAllocation(size_t row, int resource) const { return allocation[resource][row]; }
+    int getNeed(size_t row, int resource) const { return need[resource][row]; }
+
+    // Fills order with row indices in a safe completion order starting
+    // from available. Returns false (order unspecified) if none exists.
+    bool findSafeSequence(const int available[BANKER_RESOURCES], std::vector<size_t>& order);
+};
+
+#endif
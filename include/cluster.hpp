@@ -0,0 +1,97 @@
+// ============================================
+// FILE: cluster.hpp
+// DESCRIPTION: Multi-node cluster with per-node resource pools and placement
+// ============================================
+
+#ifndef CLUSTER_HPP
+#define CLUSTER_HPP
+
+#include "resource_manager.hpp"
+#include "deadlock.hpp"
+#include <vector>
+#include <string>
+#include <atomic>
+#include <utility>
+
+class Job;
+
+enum class PlacementPolicy {
+    FIRST_FIT,   // Lowest-numbered node that fits
+    NEXT_FIT,    // Round-robin from the last placement, spreads load
+    BEST_FIT     // Node left with the least free capacity
+};
+
+// One machine: its own pool, lock and Banker's state, so allocations on
+// different nodes never touch the same mutex
+struct ClusterNode {
+    int id;
+    ResourceManager* resourceManager;
+    DeadlockManager* deadlockManager;
+    std::atomic<unsigned long> jobsPlaced;
+};
+
+class Cluster {
+private:
+    std::vector<ClusterNode*> nodes;
+    ResourceRequest nodeCapacity;
+    PlacementPolicy policy;
+
+    // NEXT_FIT resume point
+    std::atomic<size_t> cursor;
+
+    // BEST_FIT: (leftover capacity, node id) for every node that fits
+    void scoreBestFit(const ResourceRequest& needs, std::vector<std::pair<double, int>>& scored);
+
+public:
+    // Every node gets the same capacity. Node pools use the lock-free
+    // counters so placement can scan free capacity without locking.
+    Cluster(int nodeCount, const ResourceRequest& perNode,
+            PlacementPolicy placement = PlacementPolicy::NEXT_FIT, bool lockFree = true);
+    ~Cluster();
+
+    Cluster(const Cluster&) = delete;
+    Cluster& operator=(const Cluster&) = delete;
+
+    int getNodeCount() const { return static_cast<int>(nodes.size()); }
+    ClusterNode* getNode(int nodeId) { return nodes[nodeId]; }
+    PlacementPolicy getPlacementPolicy() const { return policy; }
+    static const char* getPlacementName(PlacementPolicy placement);
+
+    // Non-blocking admission: runs the node's Banker's check on each node
+    // that fits until one accepts, and assigns the job to it. Returns the
+    // node id, or -1 when no node can take the job right now. avoidNode
+    // (a node held for a backfill reservation) is skipped.
+    int admit(Job* job, int avoidNode = -1);
+    bool admitOn(Job* job, int nodeId);
+
+    // Blocking admission support: assigns the job to the node it should
+    // wait on (one that fits, else the one closest to fitting)
+    int placeJob(Job* job);
+    void recordAdmission(int nodeId);
+
+    // Releases go to the node the job was placed on
+    void release(Job* job);
+
+    // Aggregates across all nodes
+    ResourceRequest getTotalResources() const;
+    ResourceRequest getAvailableResources();
+    double getCPUUtilization();
+    double getRAMUtilization();
+    double getDiskUtilization();
+    double getNetworkUtilization();
+    int getDeadlocksPrevented() const;
+
+    // Time-weighted utilization over all nodes (see ResourceManager)
+    void resetUtilization();
+    void setSimulatedClock(const std::atomic<double>* clock);
+    double getAverageUtilization(size_t resource);
+
+    // Every node's pool and Banker's metrics, labelled node="<id>"
+    void registerMetrics(MetricsRegistry& registry);
+
+    // Report: time-averaged aggregate utilization, per-node spread and the
+    // first maxNodesListed nodes individually
+    std::string getClusterReport(int maxNodesListed = 16);
+};
+
+#endif
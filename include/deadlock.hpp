@@ -7,8 +7,27 @@
 #define DEADLOCK_HPP
 
 #include "resource_manager.hpp"
+#include "banker_matrix.hpp"
 #include <vector>
+#include <deque>
 #include <string>
+#include <chrono>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+
+// Banker's bookkeeping for one job holding resources
+struct BankerEntry {
+    int allocation[4];
+    int need[4];          // maxNeed - allocation, never negative
+};
+
+// How an approved request changes the remembered safe sequence
+struct SafetyPlan {
+    enum Kind { PREPEND, APPEND, REPLACE } kind;
+    int slack[4];
+    std::vector<int> sequence;   // REPLACE only
+};
 
 class DeadlockManager {
 private:
@@ -16,18 +35,41 @@ private:
     
     // Statistics
     int deadlocksDetected;
-    int deadlocksPrevented;
-    
-    // Helper method to check if system is in safe state
-    bool isSafeState(const ResourceRequest& request, int jobId);
-    
-    // Helper to find safe sequence
-    std::vector<int> findSafeSequence(
-        std::vector<int> available,
-        std::vector<std::vector<int>>& allocation,
-        std::vector<std::vector<int>>& maxNeed,
-        std::vector<int>& jobIds
-    );
+    std::atomic<int> deadlocksPrevented;
+    unsigned long fastPathChecks;
+    unsigned long fullChecks;
+    
+    // Persistent Banker's state, updated on every allocate and release.
+    // safeSequence is a safe completion order for the current holders and
+    // sequenceSlack[r] is how much more of resource r could leave the
+    // available pool with every step of that order still able to finish.
+    std::mutex safetyMutex;
+    std::unordered_map<int, BankerEntry> bankerState;
+    std::deque<int> safeSequence;
+    int sequenceSlack[4];
+    int totalHeld[4];
+    
+    // Scratch matrices for the full check, reused between calls
+    BankerMatrix safetyMatrix;
+    std::vector<size_t> safetyOrder;
+    
+    // Helper method to check if system is in safe state.
+    // Caller holds safetyMutex; plan is filled in when the answer is yes.
+    bool isSafeState(const ResourceRequest& request, int jobId,
+                     const ResourceRequest& available, SafetyPlan& plan);
+    void commitPlan(int jobId, const ResourceRequest& request, const SafetyPlan& plan);
+    void logSafeSequence();
+    void logApproval(int jobId);
+    
+    // Availability check plus Banker's check against a snapshot of the
+    // pool, with denials counted and logged unless countDenial is false.
+    // Caller holds safetyMutex.
+    bool evaluate(int jobId, const ResourceRequest& request,
+                  const ResourceRequest& available, SafetyPlan& plan,
+                  bool countDenial = true);
+    
+    // Drops a job from the Banker's state. Caller holds safetyMutex.
+    void forgetJob(int jobId);
 
 public:
     DeadlockManager(ResourceManager* rm);
@@ -35,9 +77,66 @@ public:
     // Main Banker's Algorithm method
     bool requestResources(int jobId, const ResourceRequest& request);
     
+    // Admits a run of requests under one acquisition of the admission
+    // lock. Each request gets the usual Banker's check against a snapshot
+    // of the pool taken when the batch opens, kept current as requests are
+    // approved. Approved requests are allocated together, in one
+    // ResourceManager critical section, when the batch commits or goes out
+    // of scope. Releases on this manager wait until then, so the holder
+    // must not block on anything a releasing thread holds. Threaded
+    // callers take Scheduler::schedulerMutex before opening a batch, as
+    // backfilling does; the single-threaded event simulator cannot race.
+    class AdmissionBatch {
+    private:
+        DeadlockManager* manager;
+        std::unique_lock<std::mutex> lock;
+        ResourceRequest available;
+        std::vector<ResourceManager::Allocation> approved;
+        
+    public:
+        explicit AdmissionBatch(DeadlockManager* dm);
+        ~AdmissionBatch();
+        
+        AdmissionBatch(const AdmissionBatch&) = delete;
+        AdmissionBatch& operator=(const AdmissionBatch&) = delete;
+        
+        // countDenial = false for an opportunistic request whose refusal
+        // is not a real denial (the job is asked again later)
+        bool request(int jobId, const ResourceRequest& needs, bool countDenial = true);
+        size_t size() const { return approved.size(); }
+        
+        // Allocates everything approved so far; the batch stays open
+        void commit();
+    };
+    
+    // Blocking variant: re-runs the safety check only when a release could
+    // satisfy the request. Returns false if the timeout expires first.
+    bool acquire(int jobId, const ResourceRequest& request,
+                 std::chrono::milliseconds timeout);
+    
+    // For a caller whose own requestResources() was just refused:
+    // refusedEpoch is getReleaseEpoch() from before that attempt, and the
+    // next safety check waits for a release after it
+    bool acquire(int jobId, const ResourceRequest& request,
+                 std::chrono::milliseconds timeout, unsigned long refusedEpoch);
+    unsigned long getReleaseEpoch() { return resourceManager->getReleaseEpoch(); }
+    
+    // Releases go through here so the Banker's state stays in step
+    void releaseResources(int jobId);
+    
     // Statistics methods
     int getDeadlocksDetected() const { return deadlocksDetected; }
     int getDeadlocksPrevented() const { return deadlocksPrevented; }
+    unsigned long getFastPathChecks() const { return fastPathChecks; }
+    unsigned long getFullChecks() const { return fullChecks; }
+    
+    // Largest request the max-need model can ever approve on this pool,
+    // even with nothing else running
+    ResourceRequest getLargestAdmissible() const;
+    
+    // Prevented deadlocks and safety checks by kind; the check counts are
+    // read under safetyMutex at scrape time
+    void registerMetrics(MetricsRegistry& registry, const std::string& labels = "");
     
     // Utility
     std::string getSafetyReport();
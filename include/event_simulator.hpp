@@ -0,0 +1,118 @@
+// ============================================
+// FILE: event_simulator.hpp
+// DESCRIPTION: Discrete-event simulation engine with a virtual clock
+// ============================================
+
+#ifndef EVENT_SIMULATOR_HPP
+#define EVENT_SIMULATOR_HPP
+
+#include "resource_manager.hpp"
+#include "deadlock.hpp"
+#include "scheduler.hpp"
+#include "cluster.hpp"
+#include "workload.hpp"
+#include <queue>
+#include <vector>
+#include <memory>
+#include <random>
+#include <string>
+#include <atomic>
+
+enum class SimEventType {
+    JOB_ARRIVAL,
+    PHASE_COMPLETE,
+    RESOURCE_RELEASE
+};
+
+struct SimEvent {
+    double time;              // Virtual clock, seconds
+    unsigned long sequence;   // Keeps simultaneous events in FIFO order
+    SimEventType type;
+    Job* job;
+    int phase;                // Phase that completes (PHASE_COMPLETE only)
+    double phaseLength;       // Seconds per phase for this job
+};
+
+// Orders the event list earliest-first
+struct SimEventLater {
+    bool operator()(const SimEvent& a, const SimEvent& b) const {
+        if (a.time != b.time) return a.time > b.time;
+        return a.sequence > b.sequence;
+    }
+};
+
+// Replaces every wall-clock sleep of the threaded mode with events on a
+// virtual clock. Admission still goes through the same Scheduler ready
+// queue, DeadlockManager and ResourceManager (or a Cluster of them).
+class EventSimulator {
+private:
+    ResourceManager* resourceManager;
+    DeadlockManager* deadlockManager;
+    Cluster* cluster;
+    Scheduler* scheduler;
+    JobSource* source;
+
+    std::priority_queue<SimEvent, std::vector<SimEvent>, SimEventLater> events;
+    double clock;
+    unsigned long nextSequence;
+    
+    // Also read by metrics scrapes from other threads. publishedClock is
+    // clock as the pools' utilization accounting sees it, so a scrape
+    // never reads clock while the simulator writes it.
+    std::atomic<unsigned long> eventsProcessed;
+    std::atomic<double> publishedClock;
+
+    // Runtime jitter, seeded so runs are repeatable
+    std::mt19937 gen;
+
+    // Head job that was refused and the release count it was refused at;
+    // admission is not retried until either changes
+    Job* blockedHead;
+    unsigned long blockedEpoch;
+    unsigned long releaseCount;
+
+    // Cluster mode: nodes released since the head was refused. Only they
+    // can have changed, so a refused head is retried on them alone.
+    std::vector<int> releasedNodes;
+
+    // Jobs admitted by the current dispatch pass, started once the
+    // admission batch has allocated them
+    std::vector<Job*> admittedJobs;
+
+    bool admit(Job* job, DeadlockManager::AdmissionBatch* batch);
+
+    void pushEvent(double time, SimEventType type, Job* job, int phase = 0, double phaseLength = 0);
+    void scheduleNextArrival();
+    void dispatchReadyJobs();
+    void backfill(Job* head);
+    void startJob(Job* job);
+
+    void handleArrival(const SimEvent& event);
+    void handlePhaseComplete(const SimEvent& event);
+    void handleRelease(const SimEvent& event);
+
+public:
+    EventSimulator(ResourceManager* rm, DeadlockManager* dm, Scheduler* sched,
+                   JobSource* jobSource, unsigned int seed);
+    EventSimulator(Cluster* nodes, Scheduler* sched, JobSource* jobSource, unsigned int seed);
+    ~EventSimulator();
+
+    // Runs until the source is exhausted and every job has finished
+    void run();
+
+    // Statistics
+    double getSimulatedTime() const { return clock; }
+    unsigned long getEventsProcessed() const { return eventsProcessed.load(); }
+
+    // Share of the capacity of resource r held over the run, in percent,
+    // from the pools' time-weighted accounting on the virtual clock
+    double getAverageUtilization(size_t resource) const;
+
+    // Simulated time and events processed
+    void registerMetrics(MetricsRegistry& registry);
+
+    // Report
+    std::string getSimulationReport() const;
+};
+
+#endif
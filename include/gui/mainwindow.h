@@ -62,7 +62,7 @@ private:
     void setupStatusBar();
     
     // Simulation
-    void runSimulation(int numJobs);
+    void runSimulation(int numJobs, SchedulingAlgorithm algorithm);
     void cleanupSimulation();
     
     // Display helpers
@@ -108,6 +108,8 @@ private:
     QLabel *lblFinalAvgWaitTime;
     QLabel *lblFinalAvgTurnaroundTime;
     QLabel *lblFinalThroughput;
+    QLabel *lblFinalWaitPercentiles;
+    QLabel *lblFinalTurnaroundPercentiles;
     QLabel *lblFinalCPUUtil;
     QLabel *lblFinalRAMUtil;
     QLabel *lblFinalDiskUtil;
@@ -127,6 +129,10 @@ private:
     DeadlockManager* deadlockManager;
     Scheduler* scheduler;
     
+    // Utilization bars show the average since the previous UI tick
+    UtilizationSample lastUtilizationSample;
+    bool haveUtilizationSample;
+    int lastLoggedPeakCPU;
     
     std::thread simulationThread;
     
@@ -1,6 +1,6 @@
 // ============================================
 // FILE: job.hpp
-// DESCRIPTION: Job class representing threads
+// DESCRIPTION: Job class representing tasks run by the JobExecutor
 // ============================================
 
 #ifndef JOB_HPP
@@ -40,26 +40,53 @@ private:
     double waitingTime; 
     double executionTime; 
     
-    // Thread
-    std::thread* jobThread;
+    // Simulated clock timestamps (discrete-event mode), in seconds
+    double simArrivalTime;
+    double simStartTime;
     
-    // References to managers
+    // References to managers (those of the assigned node in a Cluster)
     ResourceManager* resourceManager;
     DeadlockManager* deadlockManager;
+    int nodeId;
+    
+    // Measured runtime from a replayed trace; 0 uses the runtime model
+    int fixedRuntimeMs;
     
     // Job execution logic
-    void run();
     void executeTask();
 
 public:
     Job(int jobId, JobPriority prio, ResourceRequest needs,
         ResourceManager* rm, DeadlockManager* dm);
     
-    ~Job();
+    // Admission - called by the Scheduler's dispatcher. Blocks until the
+    // resources are granted or the timeout expires.
+    bool acquireResources(std::chrono::milliseconds timeout);
+    
+    // Records the admission time and waiting time. acquireResources()
+    // calls it; backfilled jobs are admitted without blocking and call it
+    // directly.
+    void recordAdmitted();
+    
+    // Task body - runs on a JobExecutor worker once resources are held
+    void run();
+    
+    // Cluster placement: the job allocates from, and releases to, this
+    // node's managers. Only valid while the job holds no resources.
+    void assignNode(int node, ResourceManager* rm, DeadlockManager* dm);
+    
+    // Discrete-event mode: the EventSimulator drives the lifecycle on its
+    // virtual clock instead of run() sleeping through the phases
+    void recordSimulatedArrival(double now);
+    void recordSimulatedStart(double now);
+    void recordSimulatedCompletion(double now);
     
-    // Thread management
-    void start();
-    void join();
+    // Runtime model shared by executeTask() and the simulator. A fixed
+    // runtime replaces the model and is run exactly, without jitter.
+    int getEstimatedRuntimeMs() const;
+    void setFixedRuntimeMs(int ms) { fixedRuntimeMs = ms; }
+    bool hasFixedRuntime() const { return fixedRuntimeMs > 0; }
+    static const char* getPhaseDescription(int phase);
     
     // Getters
     int getId() const { return id; }
@@ -68,6 +95,7 @@ public:
     double getWaitingTime() const { return waitingTime; }
     double getExecutionTime() const { return executionTime; }
     ResourceRequest getResourceNeeds() const { return resourceNeeds; }
+    int getNodeId() const { return nodeId; }
     
     // Priority comparison for scheduling
     bool operator<(const Job& other) const {
@@ -0,0 +1,51 @@
+// ============================================
+// FILE: job_executor.hpp
+// DESCRIPTION: Fixed-size worker pool that runs job tasks
+// ============================================
+
+#ifndef JOB_EXECUTOR_HPP
+#define JOB_EXECUTOR_HPP
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <queue>
+#include <vector>
+
+class JobExecutor {
+private:
+    std::vector<std::thread> workers;
+
+    // Task queue shared by all workers
+    std::queue<std::function<void()>> tasks;
+    std::mutex queueMutex;
+    std::condition_variable taskCV;
+    std::condition_variable idleCV;
+
+    int activeTasks;
+    bool stopping;
+
+    void workerLoop();
+
+public:
+    // threadCount = 0 sizes the pool to the hardware concurrency
+    explicit JobExecutor(unsigned int threadCount = 0);
+    ~JobExecutor();
+
+    JobExecutor(const JobExecutor&) = delete;
+    JobExecutor& operator=(const JobExecutor&) = delete;
+
+    // Queue a task for execution on one of the workers
+    void submit(std::function<void()> task);
+
+    // Block until the queue is empty and no worker is busy
+    void waitForIdle();
+
+    // Statistics
+    unsigned int getThreadCount() const { return static_cast<unsigned int>(workers.size()); }
+    size_t getPendingTasks();
+    int getActiveTasks();
+};
+
+#endif
@@ -0,0 +1,70 @@
+// ============================================
+// FILE: latency_histogram.hpp
+// DESCRIPTION: Lock-free log-linear histogram for latency percentiles
+// ============================================
+
+#ifndef LATENCY_HISTOGRAM_HPP
+#define LATENCY_HISTOGRAM_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// HDR-style histogram of durations in seconds, kept as whole ticks of the
+// resolution (microseconds unless told otherwise). Values below 128 ticks
+// get a bucket each; every power of two above that is split into 64 linear
+// buckets, so any recorded value is known to within 1/64 (1.6%) across the
+// whole 64-bit range.
+//
+// record() is a few relaxed atomic increments and never locks, so any
+// number of threads may record at once. Histograms with the same layout
+// merge by adding bucket counts.
+class LatencyHistogram {
+public:
+    static const int SUB_BUCKET_BITS = 7;
+    static const size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    static const size_t HALF_COUNT = SUB_BUCKET_COUNT / 2;
+    static const size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (64 - SUB_BUCKET_BITS) * HALF_COUNT;
+
+private:
+    const double ticksPerSecond;
+    std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalTicks;
+    std::atomic<uint64_t> minTicks;
+    std::atomic<uint64_t> maxTicks;
+
+    static size_t bucketIndex(uint64_t ticks);
+    static uint64_t bucketUpperBound(size_t index);
+
+public:
+    // resolution is the tick length in seconds
+    explicit LatencyHistogram(double resolution = 1e-6);
+
+    LatencyHistogram(const LatencyHistogram&) = delete;
+    LatencyHistogram& operator=(const LatencyHistogram&) = delete;
+
+    // Negative durations count as zero
+    void record(double seconds);
+
+    // Adds other's samples to this one; both must share a resolution
+    void merge(const LatencyHistogram& other);
+
+    void reset();
+
+    uint64_t getCount() const { return count.load(std::memory_order_relaxed); }
+    double getMin() const;
+    double getMax() const;
+    double getMean() const;
+    double getSum() const;
+
+    // Samples in buckets that lie wholly at or below seconds, so a bucket
+    // straddling the bound is left out (Prometheus le buckets)
+    uint64_t getCountAtOrBelow(double seconds) const;
+
+    // Smallest value that percentile percent (0-100) of the samples do not
+    // exceed, in seconds, to the bucket's precision; 0 when empty
+    double getPercentile(double percent) const;
+};
+
+#endif
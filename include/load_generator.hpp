@@ -0,0 +1,60 @@
+// ============================================
+// FILE: load_generator.hpp
+// DESCRIPTION: Open-loop load generator feeding a running Scheduler
+// ============================================
+
+#ifndef LOAD_GENERATOR_HPP
+#define LOAD_GENERATOR_HPP
+
+#include "scheduler.hpp"
+#include "workload.hpp"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+// Replays a JobSource on the wall clock: each job is created and added to
+// the Scheduler at its arrival time, whether or not the system keeps up.
+// Pair it with Scheduler::startOnline().
+class LoadGenerator {
+private:
+    Scheduler* scheduler;
+    JobSource* source;
+
+    // Managers handed to each Job; both null in cluster mode, where jobs
+    // get their node's managers at placement
+    ResourceManager* resourceManager;
+    DeadlockManager* deadlockManager;
+
+    std::thread generatorThread;
+    std::mutex stopMutex;
+    std::condition_variable stopCV;
+    bool stopping;
+
+    unsigned long generated;
+    std::chrono::steady_clock::time_point startTime;
+    std::chrono::steady_clock::time_point lastArrival;
+
+    void run();
+
+public:
+    LoadGenerator(Scheduler* sched, JobSource* jobSource, ResourceManager* rm, DeadlockManager* dm);
+    ~LoadGenerator();
+
+    LoadGenerator(const LoadGenerator&) = delete;
+    LoadGenerator& operator=(const LoadGenerator&) = delete;
+
+    void start();
+
+    // Waits until the source is exhausted
+    void join();
+
+    // Stops early; jobs already added stay with the Scheduler
+    void stop();
+
+    // Valid once joined
+    unsigned long getGeneratedJobs() const { return generated; }
+    double getOfferedRate() const;
+};
+
+#endif
@@ -13,25 +13,145 @@
 #include <iomanip>
 #include <sstream>
 #include <iostream>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <memory>
+#include <condition_variable>
+#include <cstdio>
+#include "ring_buffer.hpp"
+#include "profiled_mutex.hpp"
+#include "trace_format.hpp"
+#include "summary_store.hpp"
+
+// What an asynchronous producer does when the ring buffer is full
+enum class OverflowPolicy {
+    BLOCK,        // Wait for the writer thread to make room
+    DROP,         // Discard the record
+    COUNT_DROPS   // Discard the record and report the loss in the log
+};
+
+// Where a Logger writes. DETACHED owns no files and starts disabled, for
+// runs that must not share logging state (traces can still be opened).
+enum class LoggerOutput {
+    FILES,      // logs/system.log, logs/job_summaries.* and the console
+    DETACHED
+};
+
+// One queued log line; formatting happens on the writer thread
+struct LogRecord {
+    std::chrono::system_clock::time_point timestamp;
+    std::string message;
+};
 
 class Logger {
 private:
     std::ofstream systemLog;
-    std::mutex logMutex;
+    ProfiledMutex logMutex;
+    std::atomic<bool> enabled;
+    
+    // Asynchronous mode: producers push into the ring buffer, a single
+    // writer thread batches the file/console writes
+    std::unique_ptr<MpmcRingBuffer<LogRecord>> asyncQueue;
+    std::thread writerThread;
+    std::atomic<bool> asyncMode;
+    std::atomic<int> asyncProducers;     // Inside enqueueRecord right now
+    std::atomic<bool> writerStopping;
+    std::mutex writerMutex;
+    std::condition_variable writerCV;
+    OverflowPolicy overflowPolicy;
+    size_t batchSize;
+    std::chrono::milliseconds flushInterval;
+    std::atomic<unsigned long> droppedRecords;
+    unsigned long reportedDrops;
+    
+    // Binary trace sink (see trace_format.hpp)
+    std::FILE* traceFile;
+    std::mutex traceMutex;
+    std::atomic<bool> tracing;
+    
+    // Records are stamped from a simulator's virtual clock once one is
+    // attached, as ResourceManager does (guarded by traceMutex)
+    const std::atomic<double>* traceClock;
+    bool traceClockFrozen;         // Detached simulator: time stays at traceFrozenTime
+    double traceFrozenTime;
+    
+    // Caller holds traceMutex
+    void writeTraceHeader();
+    uint64_t traceTimestamp() const;
+    
+    // Per-job summaries, appended to logs/job_summaries.* (own lock)
+    std::unique_ptr<JobSummaryStore> summaryStore;
     
     std::string getCurrentTime();
+    std::string formatTime(std::chrono::system_clock::time_point when);
+    void enqueueRecord(LogRecord&& record);
+    void writerLoop();
 
 public:
-    Logger();
+    explicit Logger(LoggerOutput output = LoggerOutput::FILES);
     ~Logger();
     
     // Logging methods
     void logEvent(const std::string& message);
     void logJobEvent(int jobId, const std::string& message);
     void createJobLog(int jobId, const std::string& summary);
+    JobSummaryStore* getSummaryStore() { return summaryStore.get(); }
+    
+    // Large simulated runs switch logging off entirely
+    void setEnabled(bool on) { enabled = on; }
+    bool isEnabled() const { return enabled; }
+    
+    // Asynchronous batched mode. The writer flushes after batchSize records
+    // or flushInterval, whichever comes first. disableAsync() waits for
+    // producers already pushing, then drains the queue; later calls log
+    // synchronously.
+    void enableAsync(size_t capacity = 8192,
+                     OverflowPolicy policy = OverflowPolicy::BLOCK,
+                     size_t batch = 256,
+                     std::chrono::milliseconds interval = std::chrono::milliseconds(50));
+    void disableAsync();
+    bool isAsync() const { return asyncMode; }
+    unsigned long getDroppedRecords() const { return droppedRecords; }
+    
+    // Binary trace: fixed 32-byte records, no formatting on the hot path.
+    // Independent of setEnabled(), so text logging can be off while tracing.
+    bool openTrace(const std::string& path);
+    void closeTrace();
+    bool isTracing() const { return tracing; }
+    
+    // Attach before the first traced event; the header is rewritten to the
+    // simulated clock domain. nullptr detaches, freezing later records at
+    // the last virtual time.
+    void setSimulatedClock(const std::atomic<double>* clock);
+    void traceEvent(TraceEventType type, int jobId,
+                    int cpu = 0, int ram = 0, int disk = 0, int network = 0,
+                    uint16_t aux = 0);
 };
 
 // Global logger instance
 extern Logger* globalLogger;
 
+// Per-thread override of globalLogger. Core code logs through
+// currentLogger(), so a thread running its own simulation can install a
+// private logger and share nothing with concurrent runs.
+extern thread_local Logger* threadLogger;
+
+inline Logger* currentLogger() {
+    return threadLogger ? threadLogger : globalLogger;
+}
+
+// Installs logger as the calling thread's override until destroyed
+class ThreadLoggerScope {
+private:
+    Logger* previous;
+
+public:
+    explicit ThreadLoggerScope(Logger* logger) : previous(threadLogger) { threadLogger = logger; }
+    ~ThreadLoggerScope() { threadLogger = previous; }
+
+    ThreadLoggerScope(const ThreadLoggerScope&) = delete;
+    ThreadLoggerScope& operator=(const ThreadLoggerScope&) = delete;
+};
+
 #endif 
\ No newline at end of file
@@ -0,0 +1,46 @@
+// ============================================
+// FILE: mapped_file.hpp
+// DESCRIPTION: Read-only memory mapping of a whole file
+// ============================================
+
+#ifndef MAPPED_FILE_HPP
+#define MAPPED_FILE_HPP
+
+#include <cstddef>
+
+// Maps a file for sequential reading. Pages are read in by the OS as they
+// are first touched, so a multi-gigabyte file is usable straight after
+// open() without being loaded up front.
+class MappedFile {
+private:
+    const unsigned char* data;
+    size_t size;
+    size_t released;     // Bytes before this offset have been handed back
+#ifdef _WIN32
+    // HANDLEs, kept as void* so this header does not pull in <windows.h>
+    // and its min/max macros
+    void* file;
+    void* mapping;
+#else
+    int fd;
+#endif
+
+public:
+    MappedFile();
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const char* path);
+
+    // Tells the OS the bytes before offset will not be read again, so a
+    // long sequential scan keeps only a window of the file resident.
+    // The mapping stays valid; released pages are re-read if touched.
+    void release(size_t offset);
+
+    const unsigned char* getData() const { return data; }
+    size_t getSize() const { return size; }
+};
+
+#endif
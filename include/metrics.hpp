@@ -0,0 +1,132 @@
+// ============================================
+// FILE: metrics.hpp
+// DESCRIPTION: Metrics registry with Prometheus text exposition over a
+//              localhost HTTP listener and periodic file dumps
+// ============================================
+
+#ifndef METRICS_HPP
+#define METRICS_HPP
+
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+enum class MetricType {
+    COUNTER,
+    GAUGE,
+    HISTOGRAM
+};
+
+// Monotonic count owned by the registry; increment() is one relaxed
+// atomic add, cheap enough for any hot path
+class MetricCounter {
+private:
+    std::atomic<uint64_t> value;
+
+public:
+    MetricCounter() : value(0) {}
+
+    void increment(uint64_t n = 1) { value.fetch_add(n, std::memory_order_relaxed); }
+    uint64_t get() const { return value.load(std::memory_order_relaxed); }
+};
+
+// Named metrics, rendered on demand in the Prometheus text format. Most
+// series are read at scrape time from state the code already keeps
+// (atomic counters, lock-free histograms, getters), so registering them
+// adds nothing to the simulation itself.
+//
+// Every registered object must outlive the registry's last render().
+// labels is the Prometheus label list without braces, e.g. node="3".
+class MetricsRegistry {
+private:
+    struct Series {
+        std::string labels;
+        std::function<double()> read;          // Counters and gauges
+        const LatencyHistogram* histogram;     // Histograms
+    };
+
+    struct Family {
+        std::string name;
+        std::string help;
+        MetricType type;
+        std::vector<Series> series;
+    };
+
+    mutable std::mutex registryMutex;
+    std::vector<Family> families;
+    std::vector<MetricCounter*> ownedCounters;
+
+    Family& family(const std::string& name, const std::string& help, MetricType type);
+
+public:
+    MetricsRegistry() {}
+    ~MetricsRegistry();
+
+    MetricsRegistry(const MetricsRegistry&) = delete;
+    MetricsRegistry& operator=(const MetricsRegistry&) = delete;
+
+    // A counter the caller increments; owned by the registry
+    MetricCounter* addCounter(const std::string& name, const std::string& help,
+                              const std::string& labels = "");
+
+    // Series whose value is read when the registry is rendered
+    void addCounterFunction(const std::string& name, const std::string& help,
+                            const std::string& labels, std::function<double()> read);
+    void addGaugeFunction(const std::string& name, const std::string& help,
+                          const std::string& labels, std::function<double()> read);
+
+    // Durations in seconds, exported with cumulative le buckets
+    void addHistogram(const std::string& name, const std::string& help,
+                      const std::string& labels, const LatencyHistogram* histogram);
+
+    // Prometheus text exposition format, version 0.0.4
+    std::string render() const;
+};
+
+// Serves a registry on http://127.0.0.1:<port>/metrics and/or rewrites a
+// text file with it every interval (written to a temporary file and
+// renamed, so readers never see a partial dump). Each runs on its own
+// background thread; stop() writes the file one last time.
+class MetricsExporter {
+private:
+    const MetricsRegistry* registry;
+
+    std::thread httpThread;
+    int listenSocket;
+
+    std::thread dumpThread;
+    std::string dumpPath;
+    double dumpInterval;
+
+    std::atomic<bool> stopping;
+    std::mutex stopMutex;
+    std::condition_variable stopCV;
+
+    void serveLoop();
+    void dumpLoop();
+    void handleConnection(int client);
+
+public:
+    explicit MetricsExporter(const MetricsRegistry* metrics);
+    ~MetricsExporter();
+
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+
+    // Binds 127.0.0.1 only; false if the port cannot be bound (or on
+    // platforms without the POSIX socket API)
+    bool startHttp(int port);
+
+    // False if the file cannot be written
+    bool startFileDump(const std::string& path, double intervalSeconds);
+
+    bool writeFile() const;
+    void stop();
+};
+
+#endif
@@ -0,0 +1,191 @@
+// ============================================
+// FILE: profiled_mutex.hpp
+// DESCRIPTION: Mutex wrapper that records lock contention when built with
+//              DATACENTER_LOCK_PROFILING and is a plain std::mutex otherwise
+// ============================================
+
+#ifndef PROFILED_MUTEX_HPP
+#define PROFILED_MUTEX_HPP
+
+#include <mutex>
+#include <condition_variable>
+#include <string>
+
+#ifdef DATACENTER_LOCK_PROFILING
+
+#include "latency_histogram.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+// Contention statistics shared by every mutex with the same name, so the
+// resourceMutex of each node in a cluster lands in one profile. Recording
+// never locks: the histograms and the call-site table are all atomics.
+class LockProfile {
+public:
+    static const size_t SITE_COUNT = 64;
+
+private:
+    // A source line that had to wait for the mutex; claimed by CAS on key
+    struct Site {
+        std::atomic<uint64_t> key;             // 0 while the slot is free
+        std::atomic<const char*> file;
+        std::atomic<int> line;
+        std::atomic<uint64_t> contentions;
+        std::atomic<uint64_t> waitNanos;
+    };
+
+    const char* name;
+    std::atomic<uint64_t> acquisitions;
+    std::atomic<uint64_t> contentions;
+    std::atomic<uint64_t> unlistedContentions; // Site table was full
+    LatencyHistogram waitTime;                 // Every acquisition, in ns ticks
+    LatencyHistogram holdTime;
+    Site sites[SITE_COUNT];
+
+    void recordSite(const char* file, int line, uint64_t waitNanos);
+
+public:
+    explicit LockProfile(const char* mutexName);
+
+    LockProfile(const LockProfile&) = delete;
+    LockProfile& operator=(const LockProfile&) = delete;
+
+    // The process-wide profile for name, created on first use and kept
+    // until exit
+    static LockProfile* named(const char* name);
+
+    // Every profile created so far, in creation order
+    static std::vector<const LockProfile*> all();
+
+    // file is nullptr when the caller is unknown (a std:: lock type)
+    void recordAcquisition(const char* file, int line, uint64_t waitNanos, bool contended);
+    void recordHold(uint64_t holdNanos) { holdTime.record(holdNanos * 1e-9); }
+
+    const char* getName() const { return name; }
+    double getTotalWaitSeconds() const { return waitTime.getSum(); }
+    std::string getReport() const;
+};
+
+// Satisfies Lockable, but the call site is only known through
+// ProfiledLockGuard and ProfiledUniqueLock, which pass their own
+class ProfiledMutex {
+private:
+    std::mutex mutex;
+    LockProfile* profile;
+    std::chrono::steady_clock::time_point acquiredAt;  // Touched by the owner only
+
+    static uint64_t nanosSince(std::chrono::steady_clock::time_point start,
+                               std::chrono::steady_clock::time_point end) {
+        return static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count());
+    }
+
+public:
+    explicit ProfiledMutex(const char* name) : profile(LockProfile::named(name)) {}
+
+    ProfiledMutex(const ProfiledMutex&) = delete;
+    ProfiledMutex& operator=(const ProfiledMutex&) = delete;
+
+    void lock(const char* file, int line) {
+        // The uncontended case costs one try_lock and a clock read
+        if (mutex.try_lock()) {
+            acquiredAt = std::chrono::steady_clock::now();
+            profile->recordAcquisition(file, line, 0, false);
+            return;
+        }
+        auto start = std::chrono::steady_clock::now();
+        mutex.lock();
+        acquiredAt = std::chrono::steady_clock::now();
+        profile->recordAcquisition(file, line, nanosSince(start, acquiredAt), true);
+    }
+
+    void lock() { lock(nullptr, 0); }
+
+    bool try_lock() {
+        if (!mutex.try_lock()) return false;
+        acquiredAt = std::chrono::steady_clock::now();
+        profile->recordAcquisition(nullptr, 0, 0, false);
+        return true;
+    }
+
+    void unlock() {
+        uint64_t held = nanosSince(acquiredAt, std::chrono::steady_clock::now());
+        mutex.unlock();
+        profile->recordHold(held);
+    }
+};
+
+// std::lock_guard that tells the profile where it was taken
+class ProfiledLockGuard {
+private:
+    ProfiledMutex& mutex;
+
+public:
+    explicit ProfiledLockGuard(ProfiledMutex& m, const char* file = __builtin_FILE(),
+                               int line = __builtin_LINE())
+        : mutex(m) {
+        mutex.lock(file, line);
+    }
+    ~ProfiledLockGuard() { mutex.unlock(); }
+
+    ProfiledLockGuard(const ProfiledLockGuard&) = delete;
+    ProfiledLockGuard& operator=(const ProfiledLockGuard&) = delete;
+};
+
+// Just enough of std::unique_lock for ProfiledConditionVariable; a wait's
+// re-acquisition is charged to the line that first took the lock
+class ProfiledUniqueLock {
+private:
+    ProfiledMutex& mutex;
+    const char* file;
+    int line;
+    bool owns;
+
+public:
+    explicit ProfiledUniqueLock(ProfiledMutex& m, const char* callerFile = __builtin_FILE(),
+                                int callerLine = __builtin_LINE())
+        : mutex(m), file(callerFile), line(callerLine), owns(true) {
+        mutex.lock(file, line);
+    }
+    ~ProfiledUniqueLock() {
+        if (owns) mutex.unlock();
+    }
+
+    ProfiledUniqueLock(const ProfiledUniqueLock&) = delete;
+    ProfiledUniqueLock& operator=(const ProfiledUniqueLock&) = delete;
+
+    void lock() {
+        mutex.lock(file, line);
+        owns = true;
+    }
+    void unlock() {
+        owns = false;
+        mutex.unlock();
+    }
+};
+
+using ProfiledConditionVariable = std::condition_variable_any;
+
+#else
+
+// Profiling compiled out: the standard types under the profiled names,
+// so the locks cost exactly what they did before
+class ProfiledMutex : public std::mutex {
+public:
+    explicit ProfiledMutex(const char*) {}
+};
+
+using ProfiledLockGuard = std::lock_guard<std::mutex>;
+using ProfiledUniqueLock = std::unique_lock<std::mutex>;
+using ProfiledConditionVariable = std::condition_variable;
+
+#endif
+
+// Per-name acquisition counts, wait and hold percentiles and the call
+// sites that waited longest, busiest mutex first. Empty when profiling is
+// compiled out.
+std::string getLockContentionReport();
+
+#endif
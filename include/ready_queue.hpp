@@ -0,0 +1,89 @@
+// ============================================
+// FILE: ready_queue.hpp
+// DESCRIPTION: Sharded per-priority ready queues with a merging consumer
+// ============================================
+
+#ifndef READY_QUEUE_HPP
+#define READY_QUEUE_HPP
+
+#include "job.hpp"
+#include <deque>
+#include <vector>
+#include <mutex>
+#include <atomic>
+
+// Jobs submitted to the Scheduler land here first. Every submitting thread
+// has a home shard with one FIFO bucket per JobPriority and its own lock,
+// so concurrent submitters rarely meet. A submission is stamped with the
+// monotonic clock and a shard-local sequence number; no counter is shared
+// between shards. The consumer empties every non-empty shard in one pass,
+// one lock each, and merges the buckets in a private heap, so the policy
+// sees jobs in arrival order - or, when the policy orders by priority,
+// the highest priority first and arrival order within it.
+class ShardedReadyQueue {
+public:
+    static const int PRIORITY_CLASSES = 3;
+
+private:
+    struct Entry {
+        long long stamp;              // steady_clock ticks at submission
+        unsigned long sequence;       // Within the shard
+        Job* job;
+    };
+
+    struct Shard {
+        std::mutex mutex;
+        std::deque<Entry> buckets[PRIORITY_CLASSES];
+        std::atomic<size_t> sizes[PRIORITY_CLASSES];
+        unsigned long nextSequence;
+        std::vector<Job*> retained;   // Submitted jobs kept for cleanup
+    };
+
+    // Front of one drained bucket, as held in the merge heap
+    struct RunHead {
+        int bucket;
+        long long stamp;
+        unsigned int shard;
+        unsigned long sequence;
+        size_t run;
+    };
+
+    std::vector<Shard*> shards;
+    std::atomic<size_t> queued[PRIORITY_CLASSES];
+
+    // Consumer only: buckets taken from the shards, one run per shard and
+    // priority, and a heap holding the front of each non-empty run
+    std::vector<std::deque<Entry>> runs;
+    std::vector<RunHead> heads;
+    bool headsByPriority;
+
+    Shard* homeShard();
+    static int bucketFor(const Job* job);
+    static bool servedAfter(const RunHead& a, const RunHead& b, bool byPriority);
+    void refill(bool byPriority);
+
+public:
+    // shardCount = 0 uses one shard per hardware thread
+    explicit ShardedReadyQueue(unsigned int shardCount = 0);
+    ~ShardedReadyQueue();
+
+    ShardedReadyQueue(const ShardedReadyQueue&) = delete;
+    ShardedReadyQueue& operator=(const ShardedReadyQueue&) = delete;
+
+    // Safe from any number of threads. retain keeps the job listed until
+    // takeRetained() hands the list over.
+    void push(Job* job, bool retain);
+
+    // Single consumer: the oldest submission, or with byPriority the oldest
+    // of the highest priority queued. Submissions made after the last
+    // refill come after the jobs already merged. nullptr when empty.
+    Job* pop(bool byPriority);
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+
+    // Moves every retained job into out and clears the lists
+    void takeRetained(std::vector<Job*>& out);
+};
+
+#endif
@@ -6,53 +6,121 @@
 #ifndef RESOURCE_MANAGER_HPP
 #define RESOURCE_MANAGER_HPP
 
+#include "resource_vector.hpp"
+#include "profiled_mutex.hpp"
 #include <mutex>
+#include <atomic>
+#include <cstdint>
 #include <condition_variable>
+#include <chrono>
 #include <vector>
+#include <unordered_map>
+#include <string>
 
-struct ResourceRequest {
-    int cpuCores;
-    int ramGB;
-    int diskSlots;
-    int networkSlots;
-    
-    ResourceRequest(int cpu = 0, int ram = 0, int disk = 0, int network = 0)
-        : cpuCores(cpu), ramGB(ram), diskSlots(disk), networkSlots(network) {}
+class MetricsRegistry;
+
+// The simulator's four resources (CPU, RAM, Disk, Network)
+using ResourceRequest = ResourceVector<4>;
+
+// Point on a pool's utilization timeline: resource-seconds held per
+// resource since accounting started. Two samples bound a window.
+struct UtilizationSample {
+    double time;               // Seconds on the pool's accounting clock
+    double heldSeconds[4];
 };
 
 class ResourceManager {
 private:
     // Total resources available
-    int totalCPU;
-    int totalRAM;
-    int totalDisk;
-    int totalNetwork;
+    ResourceRequest total;
     
     // Currently available resources
-    int availableCPU;
-    int availableRAM;
-    int availableDisk;
-    int availableNetwork;
+    ResourceRequest available;
+    
+    // Lock-free reads: the available vector lives in one atomic word, 16
+    // bits per resource (CPU lowest), and the vector above is unused.
+    // Readers do a single load without the lock. Allocation and release
+    // still store it under resourceMutex, in the same step as the
+    // allocation table, so lock holders always see the two agree.
+    bool lockFree;
+    std::atomic<uint64_t> packedAvailable;
     
     // Synchronization primitives
-    std::mutex resourceMutex;
-    std::condition_variable resourceCV;
+    ProfiledMutex resourceMutex;
+    
+    // Blocked admission requests. Each waiter has its own condition
+    // variable so a release wakes only the requests it can satisfy.
+    struct Waiter {
+        const ResourceRequest* request;
+        ProfiledConditionVariable cv;
+        bool satisfiable;
+    };
+    std::vector<Waiter*> waiters;
+    unsigned long releaseEpoch;
     
+    // Caller must hold resourceMutex unless in lock-free mode
+    ResourceRequest loadAvailable() const;
+    bool fitsAvailable(const ResourceRequest& req) const;
+    
+    // Caller must hold resourceMutex in both modes
+    void storeAvailable(const ResourceRequest& free);
+    
+public:
     // Track resource allocation per job
     struct Allocation {
         int jobId;
         ResourceRequest allocated;
     };
+
+private:
+    // Dense allocation table: one slot per job holding resources, found
+    // through allocationSlots and removed by swapping in the last slot
     std::vector<Allocation> allocations;
+    std::unordered_map<int, size_t> allocationSlots;
+    
+    // Caller holds resourceMutex
+    void recordAllocation(int jobId, const ResourceRequest& req);
+    
+    // Time-weighted accounting: every allocation and release first adds
+    // allocated x (now - lastChange) to heldSeconds, so averages over any
+    // window cost nothing extra per event. The clock is the wall clock
+    // since construction, or a simulator's virtual clock once attached.
+    const std::atomic<double>* simulatedClock;
+    bool clockFrozen;              // Detached simulator: time stays at frozenTime
+    double frozenTime;
+    std::chrono::steady_clock::time_point clockOrigin;
+    double accountingStart;
+    double lastChange;
+    ResourceRequest allocated;     // Sum of all allocations
+    ResourceRequest peakAllocated; // Since accountingStart
+    double heldSeconds[4];
+    
+    // Caller holds resourceMutex
+    double clockNow() const;
+    void advanceAccounting(double now);
+    void restartAccounting();
 
 public:
-    ResourceManager(int cpu, int ram, int disk, int network);
+    // lockFree (lock-free reads) requires every total to fit in 16 bits;
+    // larger totals fall back to the mutex-protected counters
+    ResourceManager(int cpu, int ram, int disk, int network, bool lockFree = false);
+    
+    bool isLockFree() const { return lockFree; }
     
     // Resource allocation methods
     bool canAllocate(const ResourceRequest& req);
     bool allocateResources(int jobId, const ResourceRequest& req);
     void releaseResources(int jobId);
     
+    // Allocates every request in one critical section, all or nothing
+    bool allocateBatch(const std::vector<Allocation>& batch);
+    
+    // Blocking admission support: sleep until a release after seenEpoch
+    // leaves enough free resources for req, or until the deadline passes
+    unsigned long getReleaseEpoch();
+    bool waitForRelease(const ResourceRequest& req, unsigned long seenEpoch,
+                        std::chrono::steady_clock::time_point deadline);
+    
     // Query methods
     ResourceRequest getAvailableResources();
     ResourceRequest getTotalResources();
@@ -61,8 +129,30 @@ public:
     double getDiskUtilization();
     double getNetworkUtilization();
     
+    // Time-weighted utilization, in percent of capacity. The average and
+    // peak cover the time since accounting (re)started; a window between
+    // two samples gives a time series.
+    void resetUtilization();
+    UtilizationSample getUtilizationSample();
+    double getAverageUtilization(size_t resource);
+    double getPeakUtilization(size_t resource);
+    double getWindowUtilization(const UtilizationSample& from, const UtilizationSample& to,
+                                size_t resource) const;
+    
+    // Accounting follows *clock (simulated seconds) until detached with
+    // nullptr, after which time stays where the clock left it. Attaching
+    // restarts the accounting. The clock is atomic because metrics scrapes
+    // read it from other threads while the simulator advances it.
+    void setSimulatedClock(const std::atomic<double>* clock);
+    
+    // Capacity, availability, average utilization and holder count per
+    // resource, read at scrape time; labels tag every series (e.g. a node)
+    void registerMetrics(MetricsRegistry& registry, const std::string& labels = "");
+    
     // For Banker's Algorithm
     std::vector<Allocation> getAllocations();
+    bool getAllocation(int jobId, ResourceRequest& allocated);
+    size_t getAllocationCount();
 };
 
 #endif 
\ No newline at end of file
@@ -0,0 +1,162 @@
+// ============================================
+// FILE: resource_vector.hpp
+// DESCRIPTION: Compile-time N-dimensional resource vector
+// ============================================
+
+#ifndef RESOURCE_VECTOR_HPP
+#define RESOURCE_VECTOR_HPP
+
+#include <cstddef>
+
+// Dimension metadata, indexed by dimension. A ResourceVector<N> tracks the
+// first N of these.
+struct ResourceDimension {
+    const char* name;
+    const char* unit;
+};
+
+constexpr ResourceDimension RESOURCE_DIMENSIONS[] = {
+    {"CPU", "cores"},
+    {"RAM", "GB"},
+    {"Disk", "slots"},
+    {"Network", "slots"},
+    {"Accelerators", "devices"},
+    {"NVMe IOPS", "tokens"},
+    {"Licenses", "seats"}
+};
+
+constexpr size_t MAX_RESOURCE_DIMENSIONS =
+    sizeof(RESOURCE_DIMENSIONS) / sizeof(RESOURCE_DIMENSIONS[0]);
+
+// Element-wise operations shared by every ResourceVector. The loops have a
+// constant trip count and no early exit, so the only branch is the loop
+// itself; -O3 unrolls it. ResourceVector<4>, the one on the hot paths,
+// writes fits, anyNegative, equals, += and -= out in full instead.
+template <typename Vector, size_t N>
+class ResourceVectorOps {
+private:
+    Vector& self() { return static_cast<Vector&>(*this); }
+    const Vector& self() const { return static_cast<const Vector&>(*this); }
+
+public:
+    static_assert(N > 0 && N <= MAX_RESOURCE_DIMENSIONS, "Unsupported resource dimension count");
+
+    static constexpr size_t DIMENSIONS = N;
+
+    static constexpr const char* dimensionName(size_t i) { return RESOURCE_DIMENSIONS[i].name; }
+    static constexpr const char* dimensionUnit(size_t i) { return RESOURCE_DIMENSIONS[i].unit; }
+
+    // True when every dimension is within limit
+    bool fits(const Vector& limit) const {
+        bool ok = true;
+        for (size_t i = 0; i < N; i++) {
+            ok &= self()[i] <= limit[i];
+        }
+        return ok;
+    }
+
+    bool anyNegative() const {
+        bool negative = false;
+        for (size_t i = 0; i < N; i++) {
+            negative |= self()[i] < 0;
+        }
+        return negative;
+    }
+
+    Vector& operator+=(const Vector& other) {
+        for (size_t i = 0; i < N; i++) {
+            self()[i] += other[i];
+        }
+        return self();
+    }
+
+    Vector& operator-=(const Vector& other) {
+        for (size_t i = 0; i < N; i++) {
+            self()[i] -= other[i];
+        }
+        return self();
+    }
+
+    friend Vector operator+(Vector a, const Vector& b) { return a += b; }
+    friend Vector operator-(Vector a, const Vector& b) { return a -= b; }
+
+    bool equals(const Vector& other) const {
+        bool same = true;
+        for (size_t i = 0; i < N; i++) {
+            same &= self()[i] == other[i];
+        }
+        return same;
+    }
+
+    friend bool operator==(const Vector& a, const Vector& b) { return a.equals(b); }
+
+    friend bool operator!=(const Vector& a, const Vector& b) { return !(a == b); }
+};
+
+template <size_t N>
+struct ResourceVector : ResourceVectorOps<ResourceVector<N>, N> {
+    int values[N];
+
+    ResourceVector() : values{} {}
+
+    int& operator[](size_t i) { return values[i]; }
+    const int& operator[](size_t i) const { return values[i]; }
+};
+
+// The four-resource vector keeps its named fields, which the rest of the
+// simulator uses directly; operator[] maps dimensions onto them.
+template <>
+struct ResourceVector<4> : ResourceVectorOps<ResourceVector<4>, 4> {
+    int cpuCores;
+    int ramGB;
+    int diskSlots;
+    int networkSlots;
+
+    ResourceVector(int cpu = 0, int ram = 0, int disk = 0, int network = 0)
+        : cpuCores(cpu), ramGB(ram), diskSlots(disk), networkSlots(network) {}
+
+    int& operator[](size_t i) { return this->*FIELDS[i]; }
+    const int& operator[](size_t i) const { return this->*FIELDS[i]; }
+
+    // The hot operations, written out over the fields: the generic loops
+    // go through FIELDS, which -O2 leaves as a loop of table loads
+    bool fits(const ResourceVector& limit) const {
+        return (cpuCores <= limit.cpuCores) & (ramGB <= limit.ramGB) &
+               (diskSlots <= limit.diskSlots) & (networkSlots <= limit.networkSlots);
+    }
+
+    bool anyNegative() const {
+        return (cpuCores | ramGB | diskSlots | networkSlots) < 0;
+    }
+
+    ResourceVector& operator+=(const ResourceVector& other) {
+        cpuCores += other.cpuCores;
+        ramGB += other.ramGB;
+        diskSlots += other.diskSlots;
+        networkSlots += other.networkSlots;
+        return *this;
+    }
+
+    ResourceVector& operator-=(const ResourceVector& other) {
+        cpuCores -= other.cpuCores;
+        ramGB -= other.ramGB;
+        diskSlots -= other.diskSlots;
+        networkSlots -= other.networkSlots;
+        return *this;
+    }
+
+    bool equals(const ResourceVector& other) const {
+        return (cpuCores == other.cpuCores) & (ramGB == other.ramGB) &
+               (diskSlots == other.diskSlots) & (networkSlots == other.networkSlots);
+    }
+
+private:
+    static constexpr int ResourceVector::* FIELDS[4] = {
+        &ResourceVector::cpuCores,
+        &ResourceVector::ramGB,
+        &ResourceVector::diskSlots,
+        &ResourceVector::networkSlots
+    };
+};
+
+#endif
@@ -0,0 +1,113 @@
+// ============================================
+// FILE: ring_buffer.hpp
+// DESCRIPTION: Bounded lock-free multi-producer ring buffer
+// ============================================
+
+#ifndef RING_BUFFER_HPP
+#define RING_BUFFER_HPP
+
+#include <atomic>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded MPMC queue (Dmitry Vyukov's design). Each cell carries a
+// sequence number that tells producers and consumers whether the cell is
+// free or full for the current lap, so push and pop are a single CAS on
+// the shared position plus one release store on the cell.
+template <typename T>
+class MpmcRingBuffer {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T data;
+    };
+
+    std::unique_ptr<Cell[]> buffer;
+    size_t mask;
+
+    // Producers and the consumer each hammer their own cache line
+    alignas(64) std::atomic<size_t> enqueuePos;
+    alignas(64) std::atomic<size_t> dequeuePos;
+
+    static size_t roundUpToPowerOfTwo(size_t n) {
+        size_t size = 2;
+        while (size < n) size <<= 1;
+        return size;
+    }
+
+public:
+    explicit MpmcRingBuffer(size_t capacity)
+        : mask(roundUpToPowerOfTwo(capacity) - 1), enqueuePos(0), dequeuePos(0) {
+        buffer.reset(new Cell[mask + 1]);
+        for (size_t i = 0; i <= mask; i++) {
+            buffer[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    MpmcRingBuffer(const MpmcRingBuffer&) = delete;
+    MpmcRingBuffer& operator=(const MpmcRingBuffer&) = delete;
+
+    // Returns false when the buffer is full
+    bool tryPush(T&& value) {
+        size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+
+            if (diff == 0) {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        cell->data = std::move(value);
+        cell->sequence.store(pos + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Returns false when the buffer is empty
+    bool tryPop(T& value) {
+        size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        Cell* cell;
+
+        while (true) {
+            cell = &buffer[pos & mask];
+            size_t seq = cell->sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+
+            if (diff == 0) {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+
+        value = std::move(cell->data);
+        cell->sequence.store(pos + mask + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t capacity() const { return mask + 1; }
+
+    // Approximate - other threads may be pushing or popping concurrently
+    size_t sizeApprox() const {
+        size_t head = dequeuePos.load(std::memory_order_relaxed);
+        size_t tail = enqueuePos.load(std::memory_order_relaxed);
+        return tail >= head ? tail - head : 0;
+    }
+};
+
+#endif
@@ -1,6 +1,6 @@
 // ============================================
 // FILE: scheduler.hpp
-// DESCRIPTION: CPU Scheduler with Priority Scheduling
+// DESCRIPTION: CPU Scheduler with pluggable scheduling policies
 // ============================================
 
 #ifndef SCHEDULER_HPP
@@ -9,42 +9,164 @@
 #include "job.hpp"
 #include "resource_manager.hpp"
 #include "deadlock.hpp"
-#include <queue>
+#include "cluster.hpp"
+#include "job_executor.hpp"
+#include "scheduling_policy.hpp"
+#include "ready_queue.hpp"
+#include "latency_histogram.hpp"
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
 #include <mutex>
 #include <memory>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 
-// Comparator for priority queue (higher priority = lower number)
-struct JobComparator {
-    bool operator()(Job* a, Job* b) const {
-        return static_cast<int>(a->getPriority()) > static_cast<int>(b->getPriority());
-    }
+// Per-job durations kept in the latency histograms
+enum class LatencyMetric {
+    WAIT,          // Arrival to start
+    EXECUTION,     // Start to finish
+    TURNAROUND     // Arrival to finish
 };
 
 class Scheduler {
 private:
-    std::priority_queue<Job*, std::vector<Job*>, JobComparator> readyQueue;
-    std::vector<Job*> allJobs;
-    std::mutex schedulerMutex;
+    // Ready queue; the policy decides dispatch order
+    std::unique_ptr<SchedulingPolicy> policy;
+    mutable ProfiledMutex schedulerMutex;
+    
+    // Submissions land in per-thread shards without taking schedulerMutex;
+    // the consumer moves them into the policy, highest priority first
+    ShardedReadyQueue submitted;
     
     ResourceManager* resourceManager;
     DeadlockManager* deadlockManager;
     
+    // Multi-node mode: jobs are placed on cluster nodes instead of the
+    // single resourceManager/deadlockManager pair (both null then)
+    Cluster* cluster;
+    
+    // Worker pool running admitted jobs, fed by the dispatcher thread.
+    // Created on the first scheduleAll() so simulated runs stay single-threaded.
+    std::unique_ptr<JobExecutor> executor;
+    std::thread dispatcherThread;
+    
+    // Online mode: the dispatcher sleeps on arrivalCV while the queue is
+    // empty and exits only once arrivals are closed and the queue drained
+    bool online;
+    bool acceptingArrivals;
+    std::atomic<bool> dispatcherIdle;
+    std::mutex arrivalMutex;
+    std::condition_variable arrivalCV;
+    
+    // When false, jobs are deleted as soon as their statistics are recorded
+    bool retainCompletedJobs;
+    
+    // EASY backfill. The blocked head job gets a reservation at the
+    // earliest time its needs fit in some pool (the shadow time); a job
+    // behind it may start first if it is expected to finish by then, or
+    // if it leaves the head's share of the reserved pool alone.
+    struct Reservation {
+        Job* head;
+        double shadowTime;         // Seconds, on the caller's clock
+        int pool;                  // Node id (0 for the single pool), -1 when the head never fits
+        ResourceRequest extra;     // Left over in that pool once the head starts
+    };
+    size_t backfillDepth;          // Queued jobs examined per attempt; 0 = off
+    unsigned long backfilledJobs;
+    Reservation reservation;
+    bool reservationValid;
+    Job* lastBackfilled;
+    
+    // Candidates refused since the reservation was computed; nothing that
+    // could change their answer has happened, so they are not re-probed
+    std::unordered_set<Job*> refusedCandidates;
+    std::vector<ResourceRequest> projectedPools;
+    
+    // Running jobs by expected completion (start + estimated runtime),
+    // kept only while backfill is on
+    std::multimap<double, Job*> runningByEnd;
+    std::unordered_map<int, std::multimap<double, Job*>::iterator> runningSlots;
+    
+    // Origin of the threaded dispatcher's timeline
+    std::chrono::steady_clock::time_point startClock;
+    
     // Statistics
-    int totalJobs;
-    int completedJobs;
+    std::atomic<int> totalJobs;
+    std::atomic<int> completedJobs;
     double totalWaitingTime;
     double totalExecutionTime;
+    
+    // Latency distributions by metric and priority (HIGH, MEDIUM, LOW),
+    // recorded without schedulerMutex
+    LatencyHistogram latency[3][3];
+    
+    void startDispatcher();
+    void dispatchJobs();
+    bool waitForArrival();
+    bool admitJob(Job* job);
+    void drainSubmitted();   // Caller holds schedulerMutex
+    void submitJob(Job* job);
+    void admitBurst();
+    
+    void computeReservation(Job* head, double now);
+    bool admitBackfill(Job* job, double now);
+    double elapsedSeconds() const;
 
 public:
     Scheduler(ResourceManager* rm, DeadlockManager* dm);
+    explicit Scheduler(Cluster* nodes);
     ~Scheduler();
     
-    // Job management
+    // Policy selection; jobs already queued move to the new policy
+    void setSchedulingPolicy(SchedulingAlgorithm algorithm);
+    const char* getSchedulingPolicyName() const;
+    
+    // Job management. addJob is safe from any number of threads.
     void addJob(Job* job);
+    
+    // Batch mode: dispatches the queued jobs, stopping when the queue is empty
     void scheduleAll();
+    
+    // Online mode: the dispatcher stays up and takes jobs as they are
+    // added, until closeArrivals(). waitForAllJobs() then returns once
+    // everything added has run.
+    void startOnline();
+    void closeArrivals();
+    
     void waitForAllJobs();
     
+    // Ready queue access shared by the threaded dispatcher and the
+    // discrete-event engine. Both return nullptr when the queue is empty.
+    Job* peekNextJob();
+    Job* popNextJob();
+    
+    // Admission of the head job was refused. Feedback policies (MLFQ)
+    // move it; returns false when the policy keeps it where it is.
+    bool requeueRefusedHead();
+    
+    // EASY backfill, off by default. Set before scheduling starts.
+    static const size_t DEFAULT_BACKFILL_DEPTH = 32;
+    void setBackfill(bool enabled, size_t depth = DEFAULT_BACKFILL_DEPTH);
+    bool isBackfillEnabled() const { return backfillDepth > 0; }
+    unsigned long getBackfilledJobs() const;
+    
+    // The head job (queued or already popped) is blocked: admits a queued
+    // job that cannot delay the head's reservation, removes it from the
+    // queue and returns it, or nullptr. now is in seconds on the same
+    // clock as recordStart().
+    Job* backfillJob(Job* head, double now);
+    
+    // An admitted job starts running; feeds the backfill timeline
+    void recordStart(Job* job, double now);
+    
+    // Completion accounting (called once per finished job)
+    void recordCompletion(Job* job);
+    void setRetainCompletedJobs(bool retain) { retainCompletedJobs = retain; }
+    
     // Statistics
     double getAverageWaitingTime() const;
     double getAverageTurnaroundTime() const;
@@ -52,6 +174,14 @@ public:
     int getTotalJobs() const { return totalJobs; }
     int getCompletedJobs() const { return completedJobs; }
     
+    // Latency distribution of one metric for one priority class, and the
+    // merge of all three classes into out
+    const LatencyHistogram& getLatencyHistogram(LatencyMetric metric, JobPriority priority) const;
+    void mergeLatencyHistograms(LatencyMetric metric, LatencyHistogram& out) const;
+    
+    // Job counts and the latency histograms by priority
+    void registerMetrics(MetricsRegistry& registry);
+    
     // Report
     std::string getSchedulingReport() const;
 };
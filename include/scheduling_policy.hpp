@@ -0,0 +1,252 @@
+// ============================================
+// FILE: scheduling_policy.hpp
+// DESCRIPTION: Pluggable ready-queue policies for the Scheduler
+// ============================================
+
+#ifndef SCHEDULING_POLICY_HPP
+#define SCHEDULING_POLICY_HPP
+
+#include "job.hpp"
+#include <queue>
+#include <deque>
+#include <list>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+
+enum class SchedulingAlgorithm {
+    PRIORITY,
+    FCFS,
+    SJF,
+    ROUND_ROBIN,
+    MLFQ
+};
+
+// Comparator for priority queue (higher priority = lower number)
+struct JobComparator {
+    bool operator()(Job* a, Job* b) const {
+        return static_cast<int>(a->getPriority()) > static_cast<int>(b->getPriority());
+    }
+};
+
+// Binary heap with the same layout and pop order as std::priority_queue,
+// plus an ordered walk over the entries nearest the top and removal from
+// the middle, which backfilling needs. The walk is best-first from the
+// root, so it costs O(k log k) for k entries whatever the heap size;
+// entries with equal keys may be visited in a different order than they
+// would pop.
+template <typename T, typename Compare>
+class DispatchHeap {
+private:
+    std::vector<T> items;
+    Compare comp;
+
+    size_t siftUp(size_t i) {
+        while (i > 0) {
+            size_t parent = (i - 1) / 2;
+            if (!comp(items[parent], items[i])) break;
+            std::swap(items[parent], items[i]);
+            i = parent;
+        }
+        return i;
+    }
+
+    void siftDown(size_t i) {
+        size_t n = items.size();
+        while (2 * i + 1 < n) {
+            size_t child = 2 * i + 1;
+            if (child + 1 < n && comp(items[child], items[child + 1])) child++;
+            if (!comp(items[i], items[child])) break;
+            std::swap(items[i], items[child]);
+            i = child;
+        }
+    }
+
+    void eraseAt(size_t i) {
+        items[i] = items.back();
+        items.pop_back();
+        if (i < items.size() && siftUp(i) == i) {
+            siftDown(i);
+        }
+    }
+
+public:
+    bool empty() const { return items.empty(); }
+    size_t size() const { return items.size(); }
+    const T& top() const { return items.front(); }
+
+    void push(const T& item) {
+        items.push_back(item);
+        std::push_heap(items.begin(), items.end(), comp);
+    }
+
+    void pop() {
+        std::pop_heap(items.begin(), items.end(), comp);
+        items.pop_back();
+    }
+
+    // Visits up to limit entries from the top down and removes the first
+    // one the visitor accepts
+    template <typename Visit>
+    bool removeFirst(size_t limit, Visit accept) {
+        auto later = [this](size_t a, size_t b) { return comp(items[a], items[b]); };
+        std::priority_queue<size_t, std::vector<size_t>, decltype(later)> frontier(later);
+        if (!items.empty()) frontier.push(0);
+
+        for (size_t visited = 0; visited < limit && !frontier.empty(); visited++) {
+            size_t i = frontier.top();
+            frontier.pop();
+            if (accept(items[i])) {
+                eraseAt(i);
+                return true;
+            }
+            for (size_t child = 2 * i + 1; child <= 2 * i + 2 && child < items.size(); child++) {
+                frontier.push(child);
+            }
+        }
+        return false;
+    }
+};
+
+// Decides dispatch order. The Scheduler serializes all calls.
+class SchedulingPolicy {
+public:
+    virtual ~SchedulingPolicy() {}
+
+    virtual const char* getName() const = 0;
+
+    virtual void push(Job* job) = 0;
+    virtual Job* peek() = 0;        // nullptr when empty
+    virtual Job* pop() = 0;         // nullptr when empty
+    virtual size_t size() const = 0;
+
+    // True when dispatch order is by priority class first, so submissions
+    // may be handed over highest priority first instead of in arrival order
+    virtual bool ordersByPriority() const { return false; }
+
+    // Policies that react to a refused admission take the (already
+    // popped) job back in a new position
+    virtual bool hasRefusalFeedback() const { return false; }
+    virtual void requeueRefused(Job* job) { push(job); }
+    
+    // Backfill: offers up to limit queued jobs to accept in dispatch
+    // order, removes the first one accepted and returns it (nullptr when
+    // none is). The walk stays near the head, so it is O(limit)-ish.
+    virtual Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) = 0;
+};
+
+// Static priority classes - the original scheduler. O(log n).
+class PriorityPolicy : public SchedulingPolicy {
+private:
+    DispatchHeap<Job*, JobComparator> readyQueue;
+
+public:
+    const char* getName() const override { return "Priority Scheduling"; }
+    bool ordersByPriority() const override { return true; }
+    void push(Job* job) override { readyQueue.push(job); }
+    Job* peek() override;
+    Job* pop() override;
+    size_t size() const override { return readyQueue.size(); }
+    Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) override;
+};
+
+// Arrival order. O(1).
+class FCFSPolicy : public SchedulingPolicy {
+private:
+    std::deque<Job*> readyQueue;
+
+public:
+    const char* getName() const override { return "First-Come First-Served"; }
+    void push(Job* job) override { readyQueue.push_back(job); }
+    Job* peek() override;
+    Job* pop() override;
+    size_t size() const override { return readyQueue.size(); }
+    Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) override;
+};
+
+// Shortest estimated runtime first (Job::getEstimatedRuntimeMs), ties in
+// arrival order. O(log n).
+class SJFPolicy : public SchedulingPolicy {
+private:
+    struct Entry {
+        int runtimeMs;
+        unsigned long sequence;
+        Job* job;
+    };
+    struct Longer {
+        bool operator()(const Entry& a, const Entry& b) const {
+            if (a.runtimeMs != b.runtimeMs) return a.runtimeMs > b.runtimeMs;
+            return a.sequence > b.sequence;
+        }
+    };
+    DispatchHeap<Entry, Longer> readyQueue;
+    unsigned long nextSequence;
+
+public:
+    SJFPolicy() : nextSequence(0) {}
+    const char* getName() const override { return "Shortest Job First"; }
+    void push(Job* job) override;
+    Job* peek() override;
+    Job* pop() override;
+    size_t size() const override { return readyQueue.size(); }
+    Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) override;
+};
+
+// Takes turns between the HIGH, MEDIUM and LOW classes, FIFO within a
+// class, so no class waits behind an endless stream of another. O(1).
+class RoundRobinPolicy : public SchedulingPolicy {
+private:
+    static const int CLASSES = 3;
+    std::deque<Job*> classQueues[CLASSES];
+    int turn;
+    size_t count;
+
+    int nextClass() const;   // -1 when empty
+
+public:
+    RoundRobinPolicy() : turn(0), count(0) {}
+    const char* getName() const override { return "Round Robin"; }
+    void push(Job* job) override;
+    Job* peek() override;
+    Job* pop() override;
+    size_t size() const override { return count; }
+    Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) override;
+};
+
+// Multi-level feedback queue. A job starts on the highest level whose
+// quantum covers its estimated runtime (longer jobs sink, as if they had
+// used up the upper quanta). A job refused admission drops to the lowest
+// level, and every BOOST_INTERVAL dispatches all jobs return to the top
+// so nothing starves. Levels are lists, so the boost is O(1) splices.
+class MLFQPolicy : public SchedulingPolicy {
+private:
+    static const int LEVELS = 3;
+    static const int BOOST_INTERVAL = 64;
+    static const int QUANTUM_MS[LEVELS];
+
+    std::list<Job*> levels[LEVELS];
+    size_t count;
+    int dispatchesSinceBoost;
+
+    int levelFor(const Job* job) const;
+    int topLevel() const;    // -1 when empty
+    void boost();
+
+public:
+    MLFQPolicy() : count(0), dispatchesSinceBoost(0) {}
+    const char* getName() const override { return "Multi-Level Feedback Queue"; }
+    void push(Job* job) override;
+    Job* peek() override;
+    Job* pop() override;
+    size_t size() const override { return count; }
+    bool hasRefusalFeedback() const override { return true; }
+    void requeueRefused(Job* job) override;
+    Job* removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) override;
+};
+
+// Factory and name lookup ("priority", "fcfs", "sjf", "rr", "mlfq")
+SchedulingPolicy* createSchedulingPolicy(SchedulingAlgorithm algorithm);
+bool parseSchedulingAlgorithm(const std::string& name, SchedulingAlgorithm& algorithm);
+
+#endif
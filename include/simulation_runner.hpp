@@ -0,0 +1,126 @@
+// ============================================
+// FILE: simulation_runner.hpp
+// DESCRIPTION: Headless simulation runs, parallel parameter sweeps and
+//              Monte Carlo replications
+// ============================================
+
+#ifndef SIMULATION_RUNNER_HPP
+#define SIMULATION_RUNNER_HPP
+
+#include "resource_manager.hpp"
+#include "deadlock.hpp"
+#include "scheduler.hpp"
+#include "cluster.hpp"
+#include "workload.hpp"
+#include "swf_source.hpp"
+#include <string>
+#include <vector>
+#include <ostream>
+
+// Everything that defines one run. The console fills it from flags and
+// config files through applySetting(); keys are the flag names without
+// the leading dashes.
+struct SimulationConfig {
+    std::string tracePath;
+    bool lockFree = false;
+
+    // Capacity of the single box, or of every node with numNodes > 0
+    ResourceRequest capacity = ResourceRequest(16, 64, 8, 4);
+    int numNodes = 0;
+    PlacementPolicy placement = PlacementPolicy::NEXT_FIT;
+
+    SchedulingAlgorithm algorithm = SchedulingAlgorithm::PRIORITY;
+    int backfillDepth = 0;
+
+    // Arrival process; rate 0 keeps the original 10 jobs/s constant stream
+    ArrivalProcess arrivals = ArrivalProcess::CONSTANT;
+    double arrivalRate = 0;
+
+    // SWF trace replayed instead of random jobs, with trace seconds per
+    // simulated second
+    std::string swfPath;
+    double timeScale = 1.0;
+
+    // 0 leaves the count to the mode (a trace is replayed in full)
+    int numJobs = 0;
+    unsigned int seed = 42;
+};
+
+// Sets one key: trace, lock-free, cpu, ram, disk, network, nodes,
+// placement, policy, backfill, arrivals, rate, swf, time-scale, jobs, seed.
+// Returns false, leaving config unchanged, for an unknown key or value.
+bool applySetting(SimulationConfig& config, const std::string& key, const std::string& value);
+
+// Reads "key = value" lines ('#' starts a comment) in file order
+bool loadConfigFile(const std::string& path,
+                    std::vector<std::pair<std::string, std::string>>& settings);
+
+// Builds the scheduler the config describes; cluster is set in multi-node runs
+Scheduler* createScheduler(const SimulationConfig& config, ResourceManager* rm,
+                           DeadlockManager* dm, Cluster*& cluster);
+
+// Builds the arrival source for numJobs jobs; trace is set when replaying
+// an SWF file. Requests are clamped to what dm's pool can ever admit.
+// nullptr if the trace cannot be opened.
+JobSource* createJobSource(const SimulationConfig& config, int numJobs,
+                           DeadlockManager* dm, SwfJobSource*& trace);
+
+struct SimulationResult {
+    int totalJobs;
+    int completedJobs;
+    double averageWaitingTime;     // Simulated seconds
+    double averageTurnaroundTime;
+    double makespan;               // Simulated time at the last completion
+    double throughput;             // Completed jobs per simulated second
+    int deadlocksPrevented;
+    unsigned long backfilledJobs;
+    double utilization[4];         // Time-averaged percent of capacity held
+    double wallSeconds;
+};
+
+// One discrete-event run with no output. The run logs through a private
+// detached logger installed for the calling thread (writing only the
+// config's trace, if any), so concurrent runs share no state. False if
+// the job source or trace cannot be opened.
+bool runSimulation(const SimulationConfig& config, SimulationResult& result);
+
+// One point of a sweep grid: the config and, for the CSV row, the value
+// of each swept setting as it was given
+struct SweepPoint {
+    SimulationConfig config;
+    std::vector<std::string> settings;
+};
+
+// Runs every point as an independent simulation on up to threads worker
+// threads (0 = one per hardware thread). Writes a CSV header, the columns
+// followed by the result fields, and then one row per point in grid order.
+void runSweep(const std::vector<std::string>& columns, const std::vector<SweepPoint>& points,
+              unsigned int threads, std::ostream& out);
+
+// Sample mean with the half-width of its 95% confidence interval
+// (Student's t with n - 1 degrees of freedom; 0 for a single sample)
+struct Estimate {
+    double mean;
+    double halfWidth;
+};
+
+Estimate estimateMean(const std::vector<double>& samples);
+
+struct ReplicationSummary {
+    int replications;
+    Estimate averageWaitingTime;
+    Estimate averageTurnaroundTime;
+    Estimate makespan;
+    Estimate throughput;
+    Estimate utilization[4];
+    double wallSeconds;            // Whole batch, not per run
+};
+
+// Runs replications copies of config with seeds seed, seed + 1, ... as
+// independent simulations on up to threads worker threads (0 = one per
+// hardware thread) and aggregates them. Results do not depend on the
+// thread count. False if any run fails.
+bool runReplications(const SimulationConfig& config, int replications,
+                     unsigned int threads, ReplicationSummary& summary);
+
+#endif
@@ -0,0 +1,102 @@
+// ============================================
+// FILE: summary_store.hpp
+// DESCRIPTION: Append-only segmented store for job summaries
+// ============================================
+
+#ifndef SUMMARY_STORE_HPP
+#define SUMMARY_STORE_HPP
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+#include <cstdio>
+#include <cstdint>
+
+// On-disk layout inside <dir>:
+//   job_summaries.NNNN.seg  - SummaryRecordHeader + summary text, appended
+//   job_summaries.idx       - one SummaryIndexEntry per appended summary
+// Segments roll over at maxSegmentBytes. When a job id is written more
+// than once (ids restart every run) the most recent summary wins.
+//
+// Each record is flushed to its segment before its index entry is
+// written, so after a crash the index can only lag the segments. Opening
+// the store drops index entries that point past a segment's end,
+// re-indexes records written after the last good entry, and rewrites the
+// index if anything changed. Appends after a torn record start a new
+// segment, so the torn bytes are never followed by good records.
+struct SummaryRecordHeader {
+    uint32_t magic;
+    int32_t jobId;
+    uint32_t length;
+};
+
+struct SummaryIndexEntry {
+    int32_t jobId;
+    uint32_t segment;
+    uint64_t offset;      // Offset of the summary text inside the segment
+    uint32_t length;
+    uint32_t reserved;
+};
+
+static_assert(sizeof(SummaryRecordHeader) == 12, "SummaryRecordHeader must be 12 bytes");
+static_assert(sizeof(SummaryIndexEntry) == 24, "SummaryIndexEntry must be 24 bytes");
+
+class JobSummaryStore {
+private:
+    std::string directory;
+    bool readOnly;
+    bool opened;
+    uint64_t maxSegmentBytes;
+
+    std::FILE* segmentFile;
+    std::FILE* indexFile;
+    uint32_t currentSegment;
+    uint64_t segmentOffset;
+
+    std::unordered_map<int, SummaryIndexEntry> index;
+    std::vector<int> jobOrder;   // First-seen order, for listing
+    std::mutex storeMutex;
+
+    std::string segmentPath(uint32_t segment) const;
+    std::string indexPath() const;
+    bool openSegment(uint32_t segment);
+    void addToIndex(const SummaryIndexEntry& entry);
+
+    // Reads index entries up to the first one its segment cannot hold and
+    // sets segment/offset to the end of the furthest indexed record. False
+    // if an entry was dropped.
+    bool loadIndex(uint32_t& segment, uint64_t& offset);
+
+    // Indexes the records from segment/offset onwards, stopping in each
+    // segment at a torn record. Returns the number indexed; tornTail is
+    // set when the newest segment ends in a torn record.
+    size_t scanSegments(uint32_t segment, uint64_t offset, bool& tornTail);
+
+public:
+    static const uint32_t RECORD_MAGIC = 0x4D55534A; // "JSUM"
+
+    // readOnly opens an existing store for lookups without creating files
+    explicit JobSummaryStore(const std::string& dir, bool readOnly = false,
+                             uint64_t maxSegment = 64ULL << 20);
+    ~JobSummaryStore();
+
+    JobSummaryStore(const JobSummaryStore&) = delete;
+    JobSummaryStore& operator=(const JobSummaryStore&) = delete;
+
+    bool isOpen() const { return opened; }
+
+    // Sequential append of one summary
+    bool append(int jobId, const std::string& summary);
+
+    // O(1) index lookup plus one positioned read
+    bool lookup(int jobId, std::string& summary);
+
+    std::vector<int> getJobIds();
+    size_t size();
+
+    // Push buffered appends to disk
+    void flush();
+};
+
+#endif
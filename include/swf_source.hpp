@@ -0,0 +1,68 @@
+// ============================================
+// FILE: swf_source.hpp
+// DESCRIPTION: Job source replaying Standard Workload Format traces
+// ============================================
+
+#ifndef SWF_SOURCE_HPP
+#define SWF_SOURCE_HPP
+
+#include "workload.hpp"
+#include "mapped_file.hpp"
+#include <string>
+
+// Replays a trace in the Standard Workload Format (Parallel Workloads
+// Archive): one job per line, 18 whitespace-separated fields, ';' header
+// comments. The file is memory-mapped and parsed one line per next() call,
+// so replay starts at once and only a window of the file stays resident.
+//
+// Fields used: 1 job number, 2 submit time, 4 run time, 5 allocated
+// processors (else 8, requested), 7 used memory in KB per processor (else
+// 10, requested) and 15 queue number. Jobs that never ran (run time or
+// processors missing or zero) are skipped.
+//
+// The trace machine is mapped onto one node, where limit is the largest
+// request the node can admit (DeadlockManager::getLargestAdmissible):
+// processors are scaled so the whole trace machine becomes limit's CPU
+// when the "; MaxProcs:" header is present, memory is taken as is (or, if
+// the trace has none, in proportion to CPU), disk and network are one slot
+// each. Larger requests are clamped to limit.
+// Queue 0, interactive in SWF, runs at HIGH priority; the rest at MEDIUM.
+class SwfJobSource : public JobSource {
+private:
+    MappedFile file;
+    size_t offset;
+    std::string line;            // Current line, copied for parsing
+
+    ResourceRequest limit;
+    double timeScale;            // Trace seconds per simulated second
+    int maxJobs;                 // 0 = the whole trace
+    int produced;
+
+    int maxProcs;                // From the header; 0 if absent
+    bool started;
+    double firstSubmit;
+    double lastArrival;
+
+    unsigned long skipped;
+    unsigned long clamped;
+
+    // How far behind the cursor the mapping is handed back to the OS
+    static const size_t RELEASE_INTERVAL = 64 * 1024 * 1024;
+
+    bool nextLine();
+    void parseHeaderComment();
+
+public:
+    SwfJobSource(const ResourceRequest& largestRequest, double scale = 1.0, int jobLimit = 0);
+
+    bool open(const std::string& path);
+
+    bool next(JobSpec& spec) override;
+
+    int getProducedJobs() const { return produced; }
+    unsigned long getSkippedJobs() const { return skipped; }
+    unsigned long getClampedJobs() const { return clamped; }
+    int getMaxProcs() const { return maxProcs; }
+};
+
+#endif
@@ -0,0 +1,76 @@
+// ============================================
+// FILE: trace_format.hpp
+// DESCRIPTION: Binary trace record layout shared by the logger and decoder
+// ============================================
+
+#ifndef TRACE_FORMAT_HPP
+#define TRACE_FORMAT_HPP
+
+#include <cstdint>
+
+// File layout: one TraceFileHeader followed by fixed-size TraceRecords,
+// little-endian, no padding. Readers must check magic and version.
+const char TRACE_MAGIC[8] = {'D', 'C', 'T', 'R', 'A', 'C', 'E', '1'};
+const uint32_t TRACE_VERSION = 2;
+
+// What TraceRecord::timestampNs counts, recorded once in the header
+enum class TraceClockDomain : uint32_t {
+    WALL = 0,                 // system_clock, nanoseconds since the epoch
+    SIMULATED = 1             // Virtual time of a discrete-event run, in ns
+};
+
+enum class TraceEventType : uint16_t {
+    JOB_ARRIVED = 1,          // aux = priority
+    JOB_QUEUED,
+    JOB_WAITING,
+    JOB_BLOCKED,
+    JOB_DISPATCHED,
+    JOB_STARTED,
+    PHASE_STARTED,            // aux = phase number
+    JOB_COMPLETED,
+    RESOURCES_ALLOCATED,
+    RESOURCES_RELEASED,
+    REQUEST_DENIED,           // Not enough free resources
+    REQUEST_UNSAFE,           // Refused by the Banker's Algorithm
+    SAFE_STATE_VERIFIED
+};
+
+struct TraceFileHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t recordSize;
+    uint32_t clockDomain;     // TraceClockDomain
+    uint32_t reserved;
+};
+
+struct TraceRecord {
+    uint64_t timestampNs;     // In the header's clock domain
+    uint16_t type;            // TraceEventType
+    uint16_t aux;
+    int32_t jobId;
+    int32_t resources[4];     // CPU cores, RAM GB, disk slots, network slots
+};
+
+static_assert(sizeof(TraceFileHeader) == 24, "TraceFileHeader must be 24 bytes");
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must be 32 bytes");
+
+inline const char* traceEventName(uint16_t type) {
+    switch (static_cast<TraceEventType>(type)) {
+        case TraceEventType::JOB_ARRIVED: return "JOB_ARRIVED";
+        case TraceEventType::JOB_QUEUED: return "JOB_QUEUED";
+        case TraceEventType::JOB_WAITING: return "JOB_WAITING";
+        case TraceEventType::JOB_BLOCKED: return "JOB_BLOCKED";
+        case TraceEventType::JOB_DISPATCHED: return "JOB_DISPATCHED";
+        case TraceEventType::JOB_STARTED: return "JOB_STARTED";
+        case TraceEventType::PHASE_STARTED: return "PHASE_STARTED";
+        case TraceEventType::JOB_COMPLETED: return "JOB_COMPLETED";
+        case TraceEventType::RESOURCES_ALLOCATED: return "RESOURCES_ALLOCATED";
+        case TraceEventType::RESOURCES_RELEASED: return "RESOURCES_RELEASED";
+        case TraceEventType::REQUEST_DENIED: return "REQUEST_DENIED";
+        case TraceEventType::REQUEST_UNSAFE: return "REQUEST_UNSAFE";
+        case TraceEventType::SAFE_STATE_VERIFIED: return "SAFE_STATE_VERIFIED";
+        default: return "UNKNOWN";
+    }
+}
+
+#endif
@@ -0,0 +1,88 @@
+// ============================================
+// FILE: workload.hpp
+// DESCRIPTION: Job arrival sources for the simulators
+// ============================================
+
+#ifndef WORKLOAD_HPP
+#define WORKLOAD_HPP
+
+#include "job.hpp"
+#include "resource_manager.hpp"
+#include <random>
+#include <string>
+
+// Description of one job arrival, before a Job object exists
+struct JobSpec {
+    int id;
+    JobPriority priority;
+    ResourceRequest needs;
+    double arrivalTime;   // Seconds since the start of the run
+    int runtimeMs;        // Measured runtime from a trace; 0 uses the model
+};
+
+// Produces arrivals in non-decreasing arrivalTime order
+class JobSource {
+public:
+    virtual ~JobSource() = default;
+
+    // Fills spec with the next arrival; returns false once exhausted
+    virtual bool next(JobSpec& spec) = 0;
+};
+
+// Random job mix used by the console, the GUI and the simulator
+JobSpec makeRandomJobSpec(int id, std::mt19937& gen);
+
+// Builds the Job a spec describes, fixed runtime included
+Job* createJob(const JobSpec& spec, ResourceManager* rm, DeadlockManager* dm);
+
+// Open-loop arrival processes: arrivals never wait for the system
+enum class ArrivalProcess {
+    CONSTANT,   // Fixed interval 1/rate
+    POISSON,    // Exponential gaps with mean 1/rate
+    MMPP        // Two-state Markov-modulated Poisson: bursts and lulls
+};
+
+// Names: "constant", "poisson", "mmpp"
+bool parseArrivalProcess(const std::string& name, ArrivalProcess& process);
+const char* getArrivalProcessName(ArrivalProcess process);
+
+// Fixed number of random jobs. Arrival times come from a separate
+// generator, so every process sees the same job mix for a given seed.
+class RandomJobSource : public JobSource {
+private:
+    int totalJobs;
+    int generated;
+    double interArrivalTime;
+    std::mt19937 gen;
+
+    ArrivalProcess process;
+    double rate;                 // Mean arrivals per second
+    std::mt19937 arrivalGen;
+    double clock;
+
+    // MMPP: current state and when it ends. Burst-state arrivals come
+    // MMPP_BURST_FACTOR times faster than lull-state ones, and both states
+    // last MMPP_DWELL_ARRIVALS mean arrival gaps on average, which keeps
+    // the long-run rate at rate.
+    static const int MMPP_BURST_FACTOR = 4;
+    static const int MMPP_DWELL_ARRIVALS = 50;
+    bool bursting;
+    double stateEnds;
+
+    bool limited;
+    ResourceRequest limit;
+
+    double nextArrivalTime();
+
+public:
+    // Constant interval, the original behaviour
+    RandomJobSource(int numJobs, unsigned int seed, double interArrival = 0.1);
+    RandomJobSource(int numJobs, unsigned int seed, ArrivalProcess arrivals, double arrivalRate);
+
+    // Clamps every request to limit, for pools too small for the mix
+    void setRequestLimit(const ResourceRequest& largest);
+
+    bool next(JobSpec& spec) override;
+};
+
+#endif
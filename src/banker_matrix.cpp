@@ -0,0 +1,183 @@
+// ============================================
+// FILE: banker_matrix.cpp
+// DESCRIPTION: Implementation of the SoA Banker's matrices and safety search
+// ============================================
+
+#include "../include/banker_matrix.hpp"
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+    #include <emmintrin.h>
+    #define BANKER_USE_SSE2
+#endif
+
+static const size_t COLUMN_ALIGNMENT = 64;
+
+static int32_t* allocateColumn(size_t count) {
+    void* memory = ::operator new(count * sizeof(int32_t), std::align_val_t(COLUMN_ALIGNMENT));
+    std::memset(memory, 0, count * sizeof(int32_t));
+    return static_cast<int32_t*>(memory);
+}
+
+static void freeColumn(int32_t* column) {
+    if (column != nullptr) {
+        ::operator delete(column, std::align_val_t(COLUMN_ALIGNMENT));
+    }
+}
+
+// Bit i of the result is set when row base+i is unfinished and its need
+// fits in available for every resource
+static unsigned canFinishMask(int32_t* const need[BANKER_RESOURCES], const int32_t* pending,
+                              size_t base, const int available[BANKER_RESOURCES]) {
+#if defined(__AVX2__)
+    __m256i mask = _mm256_load_si256(reinterpret_cast<const __m256i*>(pending + base));
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        __m256i needs = _mm256_load_si256(reinterpret_cast<const __m256i*>(need[r] + base));
+        __m256i tooBig = _mm256_cmpgt_epi32(needs, _mm256_set1_epi32(available[r]));
+        mask = _mm256_andnot_si256(tooBig, mask);
+    }
+    return static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(mask)));
+#elif defined(BANKER_USE_SSE2)
+    unsigned result = 0;
+    for (size_t half = 0; half < BANKER_LANES; half += 4) {
+        __m128i mask = _mm_load_si128(reinterpret_cast<const __m128i*>(pending + base + half));
+        for (int r = 0; r < BANKER_RESOURCES; r++) {
+            __m128i needs = _mm_load_si128(reinterpret_cast<const __m128i*>(need[r] + base + half));
+            __m128i tooBig = _mm_cmpgt_epi32(needs, _mm_set1_epi32(available[r]));
+            mask = _mm_andnot_si128(tooBig, mask);
+        }
+        result |= static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(mask))) << half;
+    }
+    return result;
+#else
+    unsigned result = 0;
+    for (size_t lane = 0; lane < BANKER_LANES; lane++) {
+        size_t row = base + lane;
+        unsigned fits = pending[row] != 0;
+        for (int r = 0; r < BANKER_RESOURCES; r++) {
+            fits &= static_cast<unsigned>(need[r][row] <= available[r]);
+        }
+        result |= fits << lane;
+    }
+    return result;
+#endif
+}
+
+BankerMatrix::BankerMatrix() : rows(0), capacity(0), pending(nullptr) {
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        allocation[r] = nullptr;
+        need[r] = nullptr;
+    }
+}
+
+BankerMatrix::~BankerMatrix() {
+    release();
+}
+
+void BankerMatrix::release() {
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        freeColumn(allocation[r]);
+        freeColumn(need[r]);
+        allocation[r] = nullptr;
+        need[r] = nullptr;
+    }
+    freeColumn(pending);
+    pending = nullptr;
+    capacity = 0;
+}
+
+void BankerMatrix::clear() {
+    rows = 0;
+    jobIds.clear();
+}
+
+void BankerMatrix::reserve(size_t jobs) {
+    size_t padded = (jobs + BANKER_LANES - 1) / BANKER_LANES * BANKER_LANES;
+    if (padded <= capacity) return;
+
+    // Grow geometrically so a rebuild per safety check stays amortized
+    padded = std::max(padded, capacity * 2);
+
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        int32_t* grownAllocation = allocateColumn(padded);
+        int32_t* grownNeed = allocateColumn(padded);
+        if (rows > 0) {
+            std::memcpy(grownAllocation, allocation[r], rows * sizeof(int32_t));
+            std::memcpy(grownNeed, need[r], rows * sizeof(int32_t));
+        }
+        freeColumn(allocation[r]);
+        freeColumn(need[r]);
+        allocation[r] = grownAllocation;
+        need[r] = grownNeed;
+    }
+    freeColumn(pending);
+    pending = allocateColumn(padded);
+    capacity = padded;
+    jobIds.reserve(padded);
+}
+
+void BankerMatrix::addRow(int jobId, const int alloc[BANKER_RESOURCES],
+                          const int needs[BANKER_RESOURCES]) {
+    if (rows + 1 > capacity) {
+        reserve(rows + 1);
+    }
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        allocation[r][rows] = alloc[r];
+        need[r][rows] = needs[r];
+    }
+    jobIds.push_back(jobId);
+    rows++;
+}
+
+bool BankerMatrix::findSafeSequence(const int available[BANKER_RESOURCES],
+                                    std::vector<size_t>& order) {
+    order.clear();
+    if (rows == 0) return true;
+    order.reserve(rows);
+
+    size_t paddedRows = (rows + BANKER_LANES - 1) / BANKER_LANES * BANKER_LANES;
+    for (size_t i = 0; i < paddedRows; i++) {
+        pending[i] = (i < rows) ? -1 : 0;
+    }
+
+    int work[BANKER_RESOURCES];
+    for (int r = 0; r < BANKER_RESOURCES; r++) {
+        work[r] = available[r];
+    }
+
+    size_t remaining = rows;
+    while (remaining > 0) {
+        bool progress = false;
+
+        for (size_t base = 0; base < paddedRows; base += BANKER_LANES) {
+            // Finishing a job frees resources, so re-test the block until
+            // none of its remaining jobs can finish
+            unsigned mask;
+            while ((mask = canFinishMask(need, pending, base, work)) != 0) {
+                for (size_t lane = 0; lane < BANKER_LANES; lane++) {
+                    if ((mask & (1u << lane)) == 0) continue;
+
+                    size_t row = base + lane;
+                    for (int r = 0; r < BANKER_RESOURCES; r++) {
+                        work[r] += allocation[r][row];
+                    }
+                    pending[row] = 0;
+                    order.push_back(row);
+                    remaining--;
+                }
+                progress = true;
+            }
+        }
+
+        if (!progress) {
+            // No safe sequence exists
+            return false;
+        }
+    }
+
+    return true;
+}
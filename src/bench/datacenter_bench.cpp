@@ -0,0 +1,366 @@
+// ============================================
+// FILE: datacenter_bench.cpp
+// DESCRIPTION: Benchmark suite for the core hot paths, with CSV output
+//              for comparing builds
+// ============================================
+
+#include "../../include/logger.hpp"
+#include "../../include/resource_manager.hpp"
+#include "../../include/banker_matrix.hpp"
+#include "../../include/deadlock.hpp"
+#include "../../include/scheduler.hpp"
+#include "../../include/workload.hpp"
+#include "../../include/event_simulator.hpp"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <cstdlib>
+
+// Every case runs a fixed amount of work with fixed seeds, repeated so the
+// median is stable; one CSV row per case
+struct BenchOptions {
+    int repeats = 5;
+    int scale = 1;              // --quick divides the work by 10
+    std::string filter;
+    std::ostream* csv = nullptr;
+};
+
+// The code under test echoes log lines and start-up notes to std::cout,
+// which is pointed here while the suite runs: the formatting cost stays,
+// the terminal's does not, and the CSV on stdout stays clean
+class DiscardBuffer : public std::streambuf {
+private:
+    char buffer[4096];
+
+protected:
+    int overflow(int c) override {
+        setp(buffer, buffer + sizeof(buffer));
+        return traits_type::not_eof(c);
+    }
+
+public:
+    DiscardBuffer() { setp(buffer, buffer + sizeof(buffer)); }
+};
+
+static const char* CSV_HEADER =
+    "benchmark,variant,param,ops,median_ns_per_op,min_ns_per_op,ops_per_sec";
+
+// Runs body repeats times; body returns elapsed nanoseconds for ops operations
+static void report(const BenchOptions& options, const std::string& benchmark,
+                   const std::string& variant, long param, long ops,
+                   const std::function<double()>& body) {
+    std::vector<double> samples;
+    for (int i = 0; i < options.repeats; i++) {
+        samples.push_back(body() / ops);
+    }
+    std::sort(samples.begin(), samples.end());
+    double median = samples[samples.size() / 2];
+
+    std::ostream& out = *options.csv;
+    out << benchmark << ',' << variant << ',' << param << ',' << ops << ','
+        << std::fixed << std::setprecision(1) << median << ',' << samples.front() << ','
+        << std::setprecision(0) << 1e9 / median << '\n';
+    out.flush();
+}
+
+static bool selected(const BenchOptions& options, const std::string& benchmark) {
+    return options.filter.empty() || benchmark.find(options.filter) != std::string::npos;
+}
+
+static double elapsedNanos(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+}
+
+// allocateResources/releaseResources pairs from 1-64 threads on one pool,
+// each thread with its own job id. ns per op is wall time over all pairs.
+// Both modes write under resourceMutex; packed (--lock-free) also stores
+// the counters into the packed atomic its readers load.
+static void benchResourceManager(const BenchOptions& options) {
+    if (!selected(options, "rm_alloc_release")) return;
+
+    const long totalPairs = 400000 / options.scale;
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool lockFree = (mode == 1);
+        for (int threads : threadCounts) {
+            long perThread = totalPairs / threads;
+            report(options, "rm_alloc_release", lockFree ? "packed" : "mutex",
+                   threads, perThread * threads, [&]() {
+                // Room for every thread at once, so no request is refused
+                ResourceManager rm(1024, 1024, 1024, 1024, lockFree);
+                ResourceRequest request(1, 2, 1, 1);
+                std::atomic<bool> go(false);
+                std::vector<std::thread> workers;
+
+                for (int t = 0; t < threads; t++) {
+                    workers.emplace_back([&, t]() {
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        for (long i = 0; i < perThread; i++) {
+                            rm.allocateResources(t + 1, request);
+                            rm.releaseResources(t + 1);
+                        }
+                    });
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                go.store(true, std::memory_order_release);
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                return elapsedNanos(start);
+            });
+        }
+    }
+}
+
+// What --lock-free changes: 1-16 threads reading availability and
+// utilization, as the dashboards and metrics scrapes do, while four
+// threads keep allocating and releasing. ns per op is wall time over all
+// reads; the writers run until the readers finish.
+static void benchResourceReads(const BenchOptions& options) {
+    if (!selected(options, "rm_read_under_writes")) return;
+
+    const long totalReads = 400000 / options.scale;
+    const int readerCounts[] = {1, 4, 16};
+    const int WRITERS = 4;
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool lockFree = (mode == 1);
+        for (int readers : readerCounts) {
+            long perReader = totalReads / readers;
+            report(options, "rm_read_under_writes", lockFree ? "lock_free" : "mutex",
+                   readers, perReader * readers, [&]() {
+                ResourceManager rm(1024, 1024, 1024, 1024, lockFree);
+                ResourceRequest request(1, 2, 1, 1);
+                std::atomic<bool> go(false);
+                std::atomic<bool> done(false);
+                std::vector<std::thread> writers;
+                std::vector<std::thread> workers;
+
+                for (int t = 0; t < WRITERS; t++) {
+                    writers.emplace_back([&, t]() {
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        while (!done.load(std::memory_order_relaxed)) {
+                            rm.allocateResources(t + 1, request);
+                            rm.releaseResources(t + 1);
+                        }
+                    });
+                }
+                for (int t = 0; t < readers; t++) {
+                    workers.emplace_back([&]() {
+                        while (!go.load(std::memory_order_acquire)) {
+                            std::this_thread::yield();
+                        }
+                        volatile double sink = 0;
+                        for (long i = 0; i < perReader; i++) {
+                            sink = rm.getAvailableResources().cpuCores + rm.getCPUUtilization();
+                        }
+                        (void)sink;
+                    });
+                }
+
+                auto start = std::chrono::steady_clock::now();
+                go.store(true, std::memory_order_release);
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                double elapsed = elapsedNanos(start);
+                done.store(true, std::memory_order_relaxed);
+                for (auto& writer : writers) {
+                    writer.join();
+                }
+                return elapsed;
+            });
+        }
+    }
+}
+
+// Holders with the simulator's request sizes and a tight pool, as in
+// datacenter_safety_bench
+static void fillHolders(BankerMatrix& matrix, int jobs, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> amount(0, 4);
+
+    matrix.clear();
+    matrix.reserve(jobs);
+    for (int i = 0; i < jobs; i++) {
+        int held[4] = {amount(rng), amount(rng), amount(rng), amount(rng)};
+        matrix.addRow(i + 1, held, held);
+    }
+}
+
+// The Banker's check at growing holder counts. safety_full is the search
+// the full check runs (DeadlockManager::isSafeState's slow path);
+// banker_request is requestResources + releaseResources for one more job
+// with the holders admitted, so the incremental fast paths take part.
+static void benchSafetyCheck(const BenchOptions& options) {
+    const int holderCounts[] = {10, 100, 1000, 10000};
+
+    if (selected(options, "safety_full")) {
+        BankerMatrix matrix;
+        std::vector<size_t> order;
+        const int available[4] = {2, 2, 2, 2};
+        for (int jobs : holderCounts) {
+            long iterations = std::max(20L, 2000000L / jobs / options.scale);
+            fillHolders(matrix, jobs, 42);
+            report(options, "safety_full", "banker_matrix", jobs, iterations, [&]() {
+                volatile bool sink = false;
+                auto start = std::chrono::steady_clock::now();
+                for (long i = 0; i < iterations; i++) {
+                    sink = matrix.findSafeSequence(available, order);
+                }
+                (void)sink;
+                return elapsedNanos(start);
+            });
+        }
+    }
+
+    if (selected(options, "banker_request")) {
+        for (int jobs : holderCounts) {
+            long iterations = std::max(1000L, 200000L / options.scale);
+
+            // Each holder takes one of everything, leaving room for the
+            // probe's doubled need at every holder count
+            int capacity = jobs * 3 + 64;
+            ResourceManager rm(capacity, capacity, capacity, capacity);
+            DeadlockManager dm(&rm);
+            ResourceRequest unit(1, 1, 1, 1);
+            for (int i = 1; i <= jobs; i++) {
+                dm.requestResources(i, unit);
+            }
+
+            int probe = jobs + 1;
+            ResourceRequest request(2, 4, 1, 1);
+            report(options, "banker_request", "incremental", jobs, iterations, [&]() {
+                auto start = std::chrono::steady_clock::now();
+                for (long i = 0; i < iterations; i++) {
+                    dm.requestResources(probe, request);
+                    dm.releaseResources(probe);
+                }
+                return elapsedNanos(start);
+            });
+        }
+    }
+}
+
+// Logger::logEvent with text logging on: the synchronous path writes and
+// flushes under the log mutex, the async path hands records to the writer
+// thread. Time includes draining the queue.
+static void benchLogger(const BenchOptions& options) {
+    if (!selected(options, "logger_log_event")) return;
+
+    const int threadCounts[] = {1, 4};
+    const long totalMessages = 200000 / options.scale;
+
+    for (int mode = 0; mode < 2; mode++) {
+        bool async = (mode == 1);
+        for (int threads : threadCounts) {
+            long perThread = totalMessages / threads;
+            report(options, "logger_log_event", async ? "async" : "sync",
+                   threads, perThread * threads, [&]() {
+                Logger* logger = new Logger();
+                if (async) {
+                    logger->enableAsync();
+                }
+                std::vector<std::thread> workers;
+
+                auto start = std::chrono::steady_clock::now();
+                for (int t = 0; t < threads; t++) {
+                    workers.emplace_back([&, t]() {
+                        for (long i = 0; i < perThread; i++) {
+                            logger->logEvent("bench thread " + std::to_string(t) +
+                                             " message " + std::to_string(i));
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+                logger->disableAsync();
+                double nanos = elapsedNanos(start);
+
+                delete logger;
+                return nanos;
+            });
+        }
+    }
+}
+
+// End-to-end scheduling of N random jobs through the discrete-event
+// simulator: arrival, policy queue, Banker's admission and completion,
+// without the sleeps of the threaded mode. ns per op is per job.
+static void benchScheduling(const BenchOptions& options) {
+    if (!selected(options, "schedule_jobs")) return;
+
+    const int jobCounts[] = {1000, 10000, 100000};
+    for (int jobs : jobCounts) {
+        int numJobs = std::max(100, jobs / options.scale);
+        report(options, "schedule_jobs", "des_priority", numJobs, numJobs, [&]() {
+            ResourceManager rm(16, 64, 8, 4);
+            DeadlockManager dm(&rm);
+            Scheduler scheduler(&rm, &dm);
+            scheduler.setRetainCompletedJobs(false);
+            RandomJobSource source(numJobs, 42);
+            EventSimulator simulator(&rm, &dm, &scheduler, &source, 42);
+
+            auto start = std::chrono::steady_clock::now();
+            simulator.run();
+            return elapsedNanos(start);
+        });
+    }
+}
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--repeat <n>] [--quick] [--filter <name>]\n"
+              << "Benchmarks: rm_alloc_release, rm_read_under_writes, safety_full,\n"
+              << "            banker_request, logger_log_event, schedule_jobs\n";
+}
+
+int main(int argc, char* argv[]) {
+    BenchOptions options;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--repeat" && i + 1 < argc) {
+            options.repeats = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--quick") {
+            options.scale = 10;
+        } else if (arg == "--filter" && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+
+    std::ostream csv(std::cout.rdbuf());
+    options.csv = &csv;
+    DiscardBuffer discard;
+    std::cout.rdbuf(&discard);
+
+    // Everything but the logger benchmark runs with text logging off
+    globalLogger = new Logger();
+    globalLogger->setEnabled(false);
+
+    csv << CSV_HEADER << '\n';
+    benchResourceManager(options);
+    benchResourceReads(options);
+    benchSafetyCheck(options);
+    benchLogger(options);
+    benchScheduling(options);
+
+    delete globalLogger;
+    std::cout.rdbuf(csv.rdbuf());
+    return 0;
+}
@@ -0,0 +1,162 @@
+// ============================================
+// FILE: safety_bench.cpp
+// DESCRIPTION: Micro-benchmark of the Banker's safety search - nested
+//              vector matrices versus the flat SoA BankerMatrix
+// ============================================
+
+#include "../../include/banker_matrix.hpp"
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <array>
+#include <random>
+#include <chrono>
+#include <algorithm>
+
+struct BenchState {
+    std::vector<int> jobIds;
+    std::vector<std::array<int, 4>> allocation;
+    int available[4];
+};
+
+// The original DeadlockManager::findSafeSequence, kept as the baseline
+static std::vector<int> findSafeSequenceNested(
+    std::vector<int> available,
+    std::vector<std::vector<int>>& allocation,
+    std::vector<std::vector<int>>& maxNeed,
+    std::vector<int>& jobIds
+) {
+    int n = jobIds.size();
+    std::vector<bool> finished(n, false);
+    std::vector<int> safeSequence;
+
+    std::vector<std::vector<int>> need(n, std::vector<int>(4));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 4; j++) {
+            need[i][j] = maxNeed[i][j] - allocation[i][j];
+            if (need[i][j] < 0) need[i][j] = 0;
+        }
+    }
+
+    int count = 0;
+    while (count < n) {
+        bool found = false;
+
+        for (int i = 0; i < n; i++) {
+            if (finished[i]) continue;
+
+            bool canFinish = true;
+            for (int j = 0; j < 4; j++) {
+                if (need[i][j] > available[j]) {
+                    canFinish = false;
+                    break;
+                }
+            }
+
+            if (canFinish) {
+                for (int j = 0; j < 4; j++) {
+                    available[j] += allocation[i][j];
+                }
+
+                safeSequence.push_back(jobIds[i]);
+                finished[i] = true;
+                found = true;
+                count++;
+            }
+        }
+
+        if (!found) {
+            return std::vector<int>();
+        }
+    }
+
+    return safeSequence;
+}
+
+// Holders with the simulator's request sizes (maxNeed = 2 x allocation)
+// and a small pool, so several passes are needed to find the sequence
+static BenchState makeState(int jobs, unsigned int seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<int> amount(0, 4);
+
+    BenchState state;
+    for (int i = 0; i < jobs; i++) {
+        state.jobIds.push_back(i + 1);
+        state.allocation.push_back({amount(rng), amount(rng), amount(rng), amount(rng)});
+    }
+    for (int r = 0; r < 4; r++) {
+        state.available[r] = 2;
+    }
+    return state;
+}
+
+static bool runNested(const BenchState& state) {
+    // Built per check, as DeadlockManager did
+    std::vector<std::vector<int>> allocation;
+    std::vector<std::vector<int>> maxNeed;
+    std::vector<int> jobIds = state.jobIds;
+    for (const auto& held : state.allocation) {
+        allocation.push_back({held[0], held[1], held[2], held[3]});
+        maxNeed.push_back({held[0] * 2, held[1] * 2, held[2] * 2, held[3] * 2});
+    }
+    std::vector<int> available(state.available, state.available + 4);
+
+    return !findSafeSequenceNested(available, allocation, maxNeed, jobIds).empty();
+}
+
+static bool runFlat(const BenchState& state, BankerMatrix& matrix, std::vector<size_t>& order) {
+    matrix.clear();
+    matrix.reserve(state.jobIds.size());
+    for (size_t i = 0; i < state.jobIds.size(); i++) {
+        const int* held = state.allocation[i].data();
+        matrix.addRow(state.jobIds[i], held, held);
+    }
+
+    return matrix.findSafeSequence(state.available, order);
+}
+
+template <typename Check>
+static double nanosPerCheck(int iterations, Check check) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++) {
+        check();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::nano>(elapsed).count() / iterations;
+}
+
+int main() {
+    const int sizes[] = {10, 1000, 100000};
+
+    BankerMatrix matrix;
+    std::vector<size_t> order;
+
+    std::cout << "Banker's safety search (build + search per check)\n";
+    std::cout << std::setw(10) << "jobs" << std::setw(16) << "nested ns"
+              << std::setw(16) << "flat SoA ns" << std::setw(10) << "speedup"
+              << std::setw(8) << "safe" << "\n";
+
+    for (int jobs : sizes) {
+        BenchState state = makeState(jobs, 42);
+
+        bool nestedSafe = runNested(state);
+        bool flatSafe = runFlat(state, matrix, order);
+        if (nestedSafe != flatSafe) {
+            std::cerr << "Error: implementations disagree at " << jobs << " jobs\n";
+            return 1;
+        }
+
+        int iterations = std::max(5, 2000000 / jobs);
+        volatile bool sink = false;
+        double nested = nanosPerCheck(iterations, [&]() { sink = runNested(state); });
+        double flat = nanosPerCheck(iterations, [&]() { sink = runFlat(state, matrix, order); });
+
+        std::cout << std::setw(10) << jobs
+                  << std::fixed << std::setprecision(0)
+                  << std::setw(16) << nested << std::setw(16) << flat
+                  << std::setprecision(2) << std::setw(9) << nested / flat << "x"
+                  << std::setw(8) << (sink ? "yes" : "no") << "\n";
+    }
+
+    return 0;
+}
@@ -0,0 +1,296 @@
+// ============================================
+// FILE: cluster.cpp
+// DESCRIPTION: Implementation of the multi-node cluster and job placement
+// ============================================
+
+#include "../include/cluster.hpp"
+#include "../include/job.hpp"
+#include "../include/logger.hpp"
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <functional>
+
+Cluster::Cluster(int nodeCount, const ResourceRequest& perNode,
+                 PlacementPolicy placement, bool lockFree)
+    : nodeCapacity(perNode), policy(placement), cursor(0) {
+
+    if (nodeCount < 1) nodeCount = 1;
+    nodes.reserve(nodeCount);
+
+    for (int i = 0; i < nodeCount; i++) {
+        ClusterNode* node = new ClusterNode();
+        node->id = i;
+        node->resourceManager = new ResourceManager(perNode.cpuCores, perNode.ramGB,
+            perNode.diskSlots, perNode.networkSlots, lockFree);
+        node->deadlockManager = new DeadlockManager(node->resourceManager);
+        node->jobsPlaced = 0;
+        nodes.push_back(node);
+    }
+
+    currentLogger()->logEvent("Cluster initialized: " + std::to_string(nodeCount) +
+        " nodes, placement=" + getPlacementName(policy));
+}
+
+Cluster::~Cluster() {
+    for (ClusterNode* node : nodes) {
+        delete node->deadlockManager;
+        delete node->resourceManager;
+        delete node;
+    }
+}
+
+const char* Cluster::getPlacementName(PlacementPolicy placement) {
+    switch (placement) {
+        case PlacementPolicy::FIRST_FIT: return "First fit";
+        case PlacementPolicy::NEXT_FIT: return "Next fit";
+        case PlacementPolicy::BEST_FIT: return "Best fit";
+        default: return "Unknown";
+    }
+}
+
+// Fraction of a node's capacity left over after placing needs there
+static double leftoverScore(const ResourceRequest& available, const ResourceRequest& needs,
+                            const ResourceRequest& capacity) {
+    double score = 0;
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        if (capacity[r] > 0) {
+            score += static_cast<double>(available[r] - needs[r]) / capacity[r];
+        }
+    }
+    return score;
+}
+
+void Cluster::scoreBestFit(const ResourceRequest& needs, std::vector<std::pair<double, int>>& scored) {
+    scored.clear();
+    for (ClusterNode* node : nodes) {
+        ResourceRequest available = node->resourceManager->getAvailableResources();
+        if (needs.fits(available)) {
+            scored.push_back({leftoverScore(available, needs, nodeCapacity), node->id});
+        }
+    }
+}
+
+int Cluster::admit(Job* job, int avoidNode) {
+    ResourceRequest needs = job->getResourceNeeds();
+
+    if (policy == PlacementPolicy::BEST_FIT) {
+        // Tightest node first; the heap orders only as many as are tried
+        std::vector<std::pair<double, int>> scored;
+        scoreBestFit(needs, scored);
+        auto tighter = std::greater<std::pair<double, int>>();
+        std::make_heap(scored.begin(), scored.end(), tighter);
+        while (!scored.empty()) {
+            std::pop_heap(scored.begin(), scored.end(), tighter);
+            int nodeId = scored.back().second;
+            scored.pop_back();
+            if (nodeId != avoidNode && admitOn(job, nodeId)) return nodeId;
+        }
+        return -1;
+    }
+
+    // The free-capacity test is a lock-free read; only nodes that pass it
+    // run the Banker's check
+    size_t count = nodes.size();
+    size_t start = (policy == PlacementPolicy::NEXT_FIT) ? cursor.load() : 0;
+    for (size_t k = 0; k < count; k++) {
+        int nodeId = static_cast<int>((start + k) % count);
+        if (nodeId == avoidNode) continue;
+        if (nodes[nodeId]->resourceManager->canAllocate(needs) && admitOn(job, nodeId)) {
+            return nodeId;
+        }
+    }
+    return -1;
+}
+
+bool Cluster::admitOn(Job* job, int nodeId) {
+    ClusterNode* node = nodes[nodeId];
+    if (!node->deadlockManager->requestResources(job->getId(), job->getResourceNeeds())) {
+        return false;
+    }
+
+    job->assignNode(nodeId, node->resourceManager, node->deadlockManager);
+    recordAdmission(nodeId);
+    return true;
+}
+
+int Cluster::placeJob(Job* job) {
+    ResourceRequest needs = job->getResourceNeeds();
+    int chosen = -1;
+
+    if (policy == PlacementPolicy::BEST_FIT) {
+        std::vector<std::pair<double, int>> scored;
+        scoreBestFit(needs, scored);
+        if (!scored.empty()) {
+            chosen = std::min_element(scored.begin(), scored.end())->second;
+        }
+    } else {
+        size_t count = nodes.size();
+        size_t start = (policy == PlacementPolicy::NEXT_FIT) ? cursor.load() : 0;
+        for (size_t k = 0; k < count && chosen < 0; k++) {
+            int nodeId = static_cast<int>((start + k) % count);
+            if (nodes[nodeId]->resourceManager->canAllocate(needs)) chosen = nodeId;
+        }
+    }
+
+    // Nothing fits - wait on the node closest to fitting
+    if (chosen < 0) {
+        double bestShortage = 0;
+        for (ClusterNode* node : nodes) {
+            ResourceRequest available = node->resourceManager->getAvailableResources();
+            double shortage = 0;
+            for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+                if (needs[r] > available[r] && nodeCapacity[r] > 0) {
+                    shortage += static_cast<double>(needs[r] - available[r]) / nodeCapacity[r];
+                }
+            }
+            if (chosen < 0 || shortage < bestShortage) {
+                chosen = node->id;
+                bestShortage = shortage;
+            }
+        }
+    }
+
+    ClusterNode* node = nodes[chosen];
+    job->assignNode(chosen, node->resourceManager, node->deadlockManager);
+    return chosen;
+}
+
+void Cluster::recordAdmission(int nodeId) {
+    nodes[nodeId]->jobsPlaced++;
+    if (policy == PlacementPolicy::NEXT_FIT) {
+        cursor.store((nodeId + 1) % nodes.size());
+    }
+}
+
+void Cluster::release(Job* job) {
+    int nodeId = job->getNodeId();
+    if (nodeId < 0) return;
+    nodes[nodeId]->deadlockManager->releaseResources(job->getId());
+}
+
+ResourceRequest Cluster::getTotalResources() const {
+    ResourceRequest total;
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        total[r] = nodeCapacity[r] * static_cast<int>(nodes.size());
+    }
+    return total;
+}
+
+ResourceRequest Cluster::getAvailableResources() {
+    ResourceRequest available;
+    for (ClusterNode* node : nodes) {
+        available += node->resourceManager->getAvailableResources();
+    }
+    return available;
+}
+
+double Cluster::getCPUUtilization() {
+    ResourceRequest total = getTotalResources();
+    return 100.0 * (total.cpuCores - getAvailableResources().cpuCores) / total.cpuCores;
+}
+
+double Cluster::getRAMUtilization() {
+    ResourceRequest total = getTotalResources();
+    return 100.0 * (total.ramGB - getAvailableResources().ramGB) / total.ramGB;
+}
+
+double Cluster::getDiskUtilization() {
+    ResourceRequest total = getTotalResources();
+    return 100.0 * (total.diskSlots - getAvailableResources().diskSlots) / total.diskSlots;
+}
+
+double Cluster::getNetworkUtilization() {
+    ResourceRequest total = getTotalResources();
+    return 100.0 * (total.networkSlots - getAvailableResources().networkSlots) / total.networkSlots;
+}
+
+void Cluster::resetUtilization() {
+    for (ClusterNode* node : nodes) {
+        node->resourceManager->resetUtilization();
+    }
+}
+
+void Cluster::setSimulatedClock(const std::atomic<double>* clock) {
+    for (ClusterNode* node : nodes) {
+        node->resourceManager->setSimulatedClock(clock);
+    }
+}
+
+double Cluster::getAverageUtilization(size_t resource) {
+    // Nodes share a clock and start, so their held time simply adds up
+    double held = 0, capacity = 0;
+    for (ClusterNode* node : nodes) {
+        double average = node->resourceManager->getAverageUtilization(resource);
+        held += average * nodeCapacity[resource];
+        capacity += nodeCapacity[resource];
+    }
+    return (capacity > 0) ? held / capacity : 0.0;
+}
+
+void Cluster::registerMetrics(MetricsRegistry& registry) {
+    for (ClusterNode* node : nodes) {
+        std::string labels = "node=\"" + std::to_string(node->id) + "\"";
+        node->resourceManager->registerMetrics(registry, labels);
+        node->deadlockManager->registerMetrics(registry, labels);
+    }
+}
+
+int Cluster::getDeadlocksPrevented() const {
+    int prevented = 0;
+    for (ClusterNode* node : nodes) {
+        prevented += node->deadlockManager->getDeadlocksPrevented();
+    }
+    return prevented;
+}
+
+std::string Cluster::getClusterReport(int maxNodesListed) {
+    std::stringstream ss;
+    ss << std::fixed << std::setprecision(2);
+
+    // Per-node spread of time-averaged CPU utilization and placements
+    double minCPU = 100.0, maxCPU = 0, sumCPU = 0;
+    unsigned long minPlaced = 0, maxPlaced = 0, totalPlaced = 0;
+    for (ClusterNode* node : nodes) {
+        double cpu = node->resourceManager->getAverageUtilization(0);
+        unsigned long placed = node->jobsPlaced;
+        minCPU = std::min(minCPU, cpu);
+        maxCPU = std::max(maxCPU, cpu);
+        sumCPU += cpu;
+        if (node->id == 0 || placed < minPlaced) minPlaced = placed;
+        maxPlaced = std::max(maxPlaced, placed);
+        totalPlaced += placed;
+    }
+
+    ss << "\n========== CLUSTER REPORT ==========\n";
+    ss << "Nodes: " << nodes.size() << " x (CPU " << nodeCapacity.cpuCores
+       << ", RAM " << nodeCapacity.ramGB << "GB, Disk " << nodeCapacity.diskSlots
+       << ", Network " << nodeCapacity.networkSlots << ")\n";
+    ss << "Placement: " << getPlacementName(policy) << "\n";
+    ss << "Average Utilization: CPU " << getAverageUtilization(0) << "%, RAM "
+       << getAverageUtilization(1) << "%, Disk " << getAverageUtilization(2) << "%, Network "
+       << getAverageUtilization(3) << "%\n";
+    ss << "Node CPU Utilization: min " << minCPU << "%, avg "
+       << sumCPU / nodes.size() << "%, max " << maxCPU << "%\n";
+    ss << "Jobs Placed per Node: min " << minPlaced << ", avg "
+       << static_cast<double>(totalPlaced) / nodes.size() << ", max " << maxPlaced
+       << " (total " << totalPlaced << ")\n";
+    ss << "Deadlocks Prevented (all nodes): " << getDeadlocksPrevented() << "\n";
+
+    int listed = std::min(maxNodesListed, getNodeCount());
+    for (int i = 0; i < listed; i++) {
+        ResourceManager* rm = nodes[i]->resourceManager;
+        ss << "  Node " << std::setw(4) << i
+           << ": CPU " << std::setw(6) << rm->getAverageUtilization(0) << "%"
+           << "  RAM " << std::setw(6) << rm->getAverageUtilization(1) << "%"
+           << "  Disk " << std::setw(6) << rm->getAverageUtilization(2) << "%"
+           << "  Network " << std::setw(6) << rm->getAverageUtilization(3) << "%"
+           << "  Jobs " << nodes[i]->jobsPlaced << "\n";
+    }
+    if (listed < getNodeCount()) {
+        ss << "  ... " << (getNodeCount() - listed) << " more nodes\n";
+    }
+    ss << "====================================\n";
+
+    return ss.str();
+}
@@ -5,29 +5,50 @@
 
 #include "../include/deadlock.hpp"
 #include "../include/logger.hpp"
+#include "../include/metrics.hpp"
 #include <algorithm>
 #include <sstream>
+#include <limits>
+
+static_assert(ResourceRequest::DIMENSIONS == BANKER_RESOURCES,
+              "Banker's matrices must track every resource dimension");
+
+// Banker's max-need model: a job may need up to twice what it holds
+static const int MAX_NEED_FACTOR = 2;
+
+static void fillBankerEntry(BankerEntry& entry, const int allocation[4]) {
+    for (int r = 0; r < 4; r++) {
+        entry.allocation[r] = allocation[r];
+        int maxNeed = allocation[r] * MAX_NEED_FACTOR;
+        entry.need[r] = std::max(maxNeed - allocation[r], 0);
+    }
+}
 
 DeadlockManager::DeadlockManager(ResourceManager* rm) 
-    : resourceManager(rm), deadlocksDetected(0), deadlocksPrevented(0) {
-    globalLogger->logEvent("DeadlockManager initialized with Banker's Algorithm");
+    : resourceManager(rm), deadlocksDetected(0), deadlocksPrevented(0),
+      fastPathChecks(0), fullChecks(0) {
+    for (int r = 0; r < 4; r++) {
+        sequenceSlack[r] = std::numeric_limits<int>::max();
+        totalHeld[r] = 0;
+    }
+    currentLogger()->logEvent("DeadlockManager initialized with Banker's Algorithm");
 }
 
-bool DeadlockManager::requestResources(int jobId, const ResourceRequest& request) {
-    // First check if resources are currently available
-    if (!resourceManager->canAllocate(request)) {
-        globalLogger->logJobEvent(jobId, 
-            "Request denied - Insufficient resources available");
-        return false;
+ResourceRequest DeadlockManager::getLargestAdmissible() const {
+    ResourceRequest total = resourceManager->getTotalResources();
+    ResourceRequest largest;
+    for (int r = 0; r < 4; r++) {
+        largest[r] = total[r] / MAX_NEED_FACTOR;
     }
+    return largest;
+}
+
+bool DeadlockManager::requestResources(int jobId, const ResourceRequest& request) {
+    // Admission is serialized so the Banker's state matches the allocations
+    std::lock_guard<std::mutex> lock(safetyMutex);
     
-    // Check if allocation would lead to safe state (Banker's Algorithm)
-    if (!isSafeState(request, jobId)) {
-        deadlocksPrevented++;
-        globalLogger->logJobEvent(jobId, 
-            "Request denied by Banker's Algorithm - Would lead to UNSAFE state");
-        globalLogger->logEvent("⚠️ Deadlock PREVENTED (Total: " + 
-            std::to_string(deadlocksPrevented) + ")");
+    SafetyPlan plan;
+    if (!evaluate(jobId, request, resourceManager->getAvailableResources(), plan)) {
         return false;
     }
     
@@ -35,147 +56,310 @@ bool DeadlockManager::requestResources(int jobId, const ResourceRequest& request
     bool allocated = resourceManager->allocateResources(jobId, request);
     
     if (allocated) {
-        globalLogger->logJobEvent(jobId, 
-            "✅ Banker's Algorithm verified - System remains in SAFE state");
+        commitPlan(jobId, request, plan);
+        logSafeSequence();
+        logApproval(jobId);
     }
     
     return allocated;
 }
 
-bool DeadlockManager::isSafeState(const ResourceRequest& request, int jobId) {
-    // Get current system state
-    auto available = resourceManager->getAvailableResources();
-    auto allocations = resourceManager->getAllocations();
+bool DeadlockManager::evaluate(int jobId, const ResourceRequest& request,
+                               const ResourceRequest& available, SafetyPlan& plan,
+                               bool countDenial) {
+    // First check if resources are currently available
+    if (!request.fits(available)) {
+        if (!countDenial) return false;
+        currentLogger()->traceEvent(TraceEventType::REQUEST_DENIED, jobId,
+            request.cpuCores, request.ramGB, request.diskSlots, request.networkSlots);
+        currentLogger()->logJobEvent(jobId, 
+            "Request denied - Insufficient resources available");
+        return false;
+    }
     
-    // Simulate allocation
-    std::vector<int> availableVec = {
-        available.cpuCores - request.cpuCores,
-        available.ramGB - request.ramGB,
-        available.diskSlots - request.diskSlots,
-        available.networkSlots - request.networkSlots
-    };
-    
-    // Check if any resource goes negative
-    for (int res : availableVec) {
-        if (res < 0) return false;
-    }
-    
-    // Build allocation matrix
-    std::vector<std::vector<int>> allocationMatrix;
-    std::vector<std::vector<int>> maxNeedMatrix;
-    std::vector<int> jobIds;
-    
-    // Add existing allocations
-    for (const auto& alloc : allocations) {
-        jobIds.push_back(alloc.jobId);
-        allocationMatrix.push_back({
-            alloc.allocated.cpuCores,
-            alloc.allocated.ramGB,
-            alloc.allocated.diskSlots,
-            alloc.allocated.networkSlots
-        });
-        
-        // Assume max need is 2x current allocation (simplified)
-        maxNeedMatrix.push_back({
-            alloc.allocated.cpuCores * 2,
-            alloc.allocated.ramGB * 2,
-            alloc.allocated.diskSlots * 2,
-            alloc.allocated.networkSlots * 2
-        });
+    // Check if allocation would lead to safe state (Banker's Algorithm)
+    if (!isSafeState(request, jobId, available, plan)) {
+        if (!countDenial) return false;
+        deadlocksPrevented++;
+        currentLogger()->traceEvent(TraceEventType::REQUEST_UNSAFE, jobId,
+            request.cpuCores, request.ramGB, request.diskSlots, request.networkSlots);
+        if (currentLogger()->isEnabled()) {
+            currentLogger()->logJobEvent(jobId, 
+                "Request denied by Banker's Algorithm - Would lead to UNSAFE state");
+            currentLogger()->logEvent("⚠️ Deadlock PREVENTED (Total: " + 
+                std::to_string(deadlocksPrevented) + ")");
+        }
+        return false;
     }
     
-    // Add the new request
-    bool jobExists = std::find(jobIds.begin(), jobIds.end(), jobId) != jobIds.end();
-    if (!jobExists) {
-        jobIds.push_back(jobId);
-        allocationMatrix.push_back({
-            request.cpuCores,
-            request.ramGB,
-            request.diskSlots,
-            request.networkSlots
-        });
-        maxNeedMatrix.push_back({
-            request.cpuCores * 2,
-            request.ramGB * 2,
-            request.diskSlots * 2,
-            request.networkSlots * 2
-        });
+    return true;
+}
+
+void DeadlockManager::logApproval(int jobId) {
+    currentLogger()->traceEvent(TraceEventType::SAFE_STATE_VERIFIED, jobId);
+    currentLogger()->logJobEvent(jobId, 
+        "✅ Banker's Algorithm verified - System remains in SAFE state");
+}
+
+DeadlockManager::AdmissionBatch::AdmissionBatch(DeadlockManager* dm)
+    : manager(dm), lock(dm->safetyMutex) {
+    // Every allocation on the pool goes through the admission lock, which
+    // is now held, so the snapshot can only be stale by releases, and
+    // those wait for the lock too
+    available = manager->resourceManager->getAvailableResources();
+}
+
+DeadlockManager::AdmissionBatch::~AdmissionBatch() {
+    commit();
+}
+
+bool DeadlockManager::AdmissionBatch::request(int jobId, const ResourceRequest& needs,
+                                              bool countDenial) {
+    SafetyPlan plan;
+    if (!manager->evaluate(jobId, needs, available, plan, countDenial)) {
+        return false;
     }
     
-    // Find safe sequence
-    auto safeSeq = findSafeSequence(availableVec, allocationMatrix, maxNeedMatrix, jobIds);
-    
-    if (!safeSeq.empty()) {
-        std::stringstream ss;
-        ss << "Safe sequence found: [";
-        for (size_t i = 0; i < safeSeq.size(); i++) {
-            ss << safeSeq[i];
-            if (i < safeSeq.size() - 1) ss << ", ";
+    manager->commitPlan(jobId, needs, plan);
+    available -= needs;
+    approved.push_back({jobId, needs});
+    return true;
+}
+
+void DeadlockManager::AdmissionBatch::commit() {
+    if (approved.empty()) return;
+    
+    if (manager->resourceManager->allocateBatch(approved)) {
+        manager->logSafeSequence();
+        for (const auto& entry : approved) {
+            manager->logApproval(entry.jobId);
+        }
+    } else {
+        // Only possible if the pool was allocated from behind the
+        // DeadlockManager's back; nothing in the batch was allocated
+        currentLogger()->logEvent("DeadlockManager: batch allocation failed, " +
+            std::to_string(approved.size()) + " requests dropped");
+        for (const auto& entry : approved) {
+            manager->forgetJob(entry.jobId);
+        }
+    }
+    approved.clear();
+}
+
+void DeadlockManager::releaseResources(int jobId) {
+    std::lock_guard<std::mutex> lock(safetyMutex);
+    forgetJob(jobId);
+    resourceManager->releaseResources(jobId);
+}
+
+void DeadlockManager::forgetJob(int jobId) {
+    auto it = bankerState.find(jobId);
+    if (it != bankerState.end()) {
+        for (int r = 0; r < 4; r++) {
+            totalHeld[r] -= it->second.allocation[r];
+        }
+        bankerState.erase(it);
+        
+        // Dropping a job from a safe sequence leaves it safe, and the steps
+        // before it only gain resources, so the old slack stays a valid bound
+        auto pos = std::find(safeSequence.begin(), safeSequence.end(), jobId);
+        if (pos != safeSequence.end()) {
+            safeSequence.erase(pos);
         }
-        ss << "]";
-        globalLogger->logEvent(ss.str());
+        if (bankerState.empty()) {
+            for (int r = 0; r < 4; r++) {
+                sequenceSlack[r] = std::numeric_limits<int>::max();
+            }
+        }
+    }
+}
+
+bool DeadlockManager::acquire(int jobId, const ResourceRequest& request,
+                              std::chrono::milliseconds timeout) {
+    unsigned long epoch = resourceManager->getReleaseEpoch();
+    if (requestResources(jobId, request)) {
         return true;
     }
-    
-    return false;
+    return acquire(jobId, request, timeout, epoch);
 }
 
-std::vector<int> DeadlockManager::findSafeSequence(
-    std::vector<int> available,
-    std::vector<std::vector<int>>& allocation,
-    std::vector<std::vector<int>>& maxNeed,
-    std::vector<int>& jobIds
-) {
-    int n = jobIds.size();
-    std::vector<bool> finished(n, false);
-    std::vector<int> safeSequence;
+bool DeadlockManager::acquire(int jobId, const ResourceRequest& request,
+                              std::chrono::milliseconds timeout, unsigned long refusedEpoch) {
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+    unsigned long epoch = refusedEpoch;
     
-    // Calculate need matrix
-    std::vector<std::vector<int>> need(n, std::vector<int>(4));
-    for (int i = 0; i < n; i++) {
-        for (int j = 0; j < 4; j++) {
-            need[i][j] = maxNeed[i][j] - allocation[i][j];
-            if (need[i][j] < 0) need[i][j] = 0; // Prevent negative
+    while (true) {
+        // Sleep until a release frees enough resources instead of polling
+        if (!resourceManager->waitForRelease(request, epoch, deadline)) {
+            return false;
         }
+        
+        epoch = resourceManager->getReleaseEpoch();
+        if (requestResources(jobId, request)) {
+            return true;
+        }
+    }
+}
+
+bool DeadlockManager::isSafeState(const ResourceRequest& request, int jobId,
+                                  const ResourceRequest& available, SafetyPlan& plan) {
+    // Check if any resource would go negative
+    if (!request.fits(available)) return false;
+    
+    // Simulate allocation
+    int req[4];
+    int avail[4];
+    int work[4];
+    for (int r = 0; r < 4; r++) {
+        req[r] = request[r];
+        avail[r] = available[r];
+        work[r] = avail[r] - req[r];
     }
     
-    // Try to find safe sequence
-    int count = 0;
-    while (count < n) {
-        bool found = false;
+    bool jobExists = bankerState.count(jobId) > 0;
+    
+    if (!jobExists) {
+        BankerEntry candidate;
+        fillBankerEntry(candidate, req);
         
-        for (int i = 0; i < n; i++) {
-            if (finished[i]) continue;
-            
-            // Check if need[i] <= available
-            bool canFinish = true;
-            for (int j = 0; j < 4; j++) {
-                if (need[i][j] > available[j]) {
-                    canFinish = false;
-                    break;
-                }
+        // Fast path 1: the new job can finish right away, after which the
+        // pool is back to today's and the remembered sequence runs unchanged
+        bool finishesFirst = true;
+        for (int r = 0; r < 4; r++) {
+            if (candidate.need[r] > work[r]) finishesFirst = false;
+        }
+        if (finishesFirst) {
+            plan.kind = SafetyPlan::PREPEND;
+            for (int r = 0; r < 4; r++) {
+                plan.slack[r] = std::min(sequenceSlack[r], work[r] - candidate.need[r]);
             }
-            
-            if (canFinish) {
-                // Add allocated resources back to available
-                for (int j = 0; j < 4; j++) {
-                    available[j] += allocation[i][j];
-                }
-                
-                safeSequence.push_back(jobIds[i]);
-                finished[i] = true;
-                found = true;
-                count++;
+            fastPathChecks++;
+            return true;
+        }
+        
+        // Fast path 2: every step of the remembered sequence still finishes
+        // with the request taken out, and then the new job finishes last
+        bool finishesLast = true;
+        int finalWork[4];
+        for (int r = 0; r < 4; r++) {
+            finalWork[r] = avail[r] + totalHeld[r] - req[r];
+            if (req[r] > sequenceSlack[r] || candidate.need[r] > finalWork[r]) {
+                finishesLast = false;
+            }
+        }
+        if (finishesLast) {
+            plan.kind = SafetyPlan::APPEND;
+            for (int r = 0; r < 4; r++) {
+                plan.slack[r] = std::min(sequenceSlack[r] - req[r], finalWork[r] - candidate.need[r]);
             }
+            fastPathChecks++;
+            return true;
+        }
+    }
+    
+    // Full check against the persistent matrices
+    fullChecks++;
+    
+    safetyMatrix.clear();
+    safetyMatrix.reserve(bankerState.size() + 1);
+    
+    for (const auto& held : bankerState) {
+        BankerEntry entry = held.second;
+        
+        // A job asking for more is checked with its combined allocation
+        if (held.first == jobId) {
+            int combined[4];
+            for (int r = 0; r < 4; r++) combined[r] = entry.allocation[r] + req[r];
+            fillBankerEntry(entry, combined);
         }
         
-        if (!found) {
-            // No safe sequence exists
-            return std::vector<int>();
+        safetyMatrix.addRow(held.first, entry.allocation, entry.need);
+    }
+    
+    // Add the new request
+    if (!jobExists) {
+        BankerEntry candidate;
+        fillBankerEntry(candidate, req);
+        safetyMatrix.addRow(jobId, candidate.allocation, candidate.need);
+    }
+    
+    // Find safe sequence
+    if (!safetyMatrix.findSafeSequence(work, safetyOrder)) {
+        return false;
+    }
+    
+    // Exact slack of the new sequence, so later requests take a fast path
+    int step[4];
+    for (int r = 0; r < 4; r++) {
+        step[r] = work[r];
+        plan.slack[r] = std::numeric_limits<int>::max();
+    }
+    plan.sequence.clear();
+    plan.sequence.reserve(safetyOrder.size());
+    for (size_t row : safetyOrder) {
+        for (int r = 0; r < 4; r++) {
+            plan.slack[r] = std::min(plan.slack[r], step[r] - safetyMatrix.getNeed(row, r));
+            step[r] += safetyMatrix.getAllocation(row, r);
         }
+        plan.sequence.push_back(safetyMatrix.getJobId(row));
+    }
+    
+    plan.kind = SafetyPlan::REPLACE;
+    return true;
+}
+
+void DeadlockManager::commitPlan(int jobId, const ResourceRequest& request, const SafetyPlan& plan) {
+    // A job that already holds resources accumulates its allocation
+    bool existing = bankerState.count(jobId) > 0;
+    BankerEntry& entry = bankerState[jobId];
+    int allocation[4];
+    for (int r = 0; r < 4; r++) {
+        allocation[r] = (existing ? entry.allocation[r] : 0) + request[r];
+        totalHeld[r] += request[r];
+        sequenceSlack[r] = plan.slack[r];
     }
+    fillBankerEntry(entry, allocation);
     
-    return safeSequence;
+    switch (plan.kind) {
+        case SafetyPlan::PREPEND: safeSequence.push_front(jobId); break;
+        case SafetyPlan::APPEND: safeSequence.push_back(jobId); break;
+        case SafetyPlan::REPLACE:
+            safeSequence.assign(plan.sequence.begin(), plan.sequence.end());
+            break;
+    }
+}
+
+void DeadlockManager::logSafeSequence() {
+    if (!currentLogger()->isEnabled()) return;
+    
+    std::stringstream ss;
+    ss << "Safe sequence found: [";
+    for (size_t i = 0; i < safeSequence.size(); i++) {
+        ss << safeSequence[i];
+        if (i < safeSequence.size() - 1) ss << ", ";
+    }
+    ss << "]";
+    currentLogger()->logEvent(ss.str());
+}
+
+void DeadlockManager::registerMetrics(MetricsRegistry& registry, const std::string& labels) {
+    std::string prefix = labels.empty() ? "" : labels + ",";
+    
+    registry.addCounterFunction("datacenter_deadlocks_prevented_total",
+        "Requests refused because granting them would leave an unsafe state", labels,
+        [this]() { return static_cast<double>(deadlocksPrevented.load()); });
+    registry.addCounterFunction("datacenter_safety_checks_total",
+        "Banker's safety checks by path", prefix + "path=\"fast\"",
+        [this]() {
+            std::lock_guard<std::mutex> lock(safetyMutex);
+            return static_cast<double>(fastPathChecks);
+        });
+    registry.addCounterFunction("datacenter_safety_checks_total",
+        "Banker's safety checks by path", prefix + "path=\"full\"",
+        [this]() {
+            std::lock_guard<std::mutex> lock(safetyMutex);
+            return static_cast<double>(fullChecks);
+        });
 }
 
 std::string DeadlockManager::getSafetyReport() {
@@ -183,7 +367,9 @@ std::string DeadlockManager::getSafetyReport() {
     ss << "\n========== DEADLOCK MANAGEMENT REPORT ==========\n";
     ss << "Deadlocks Detected: " << deadlocksDetected << "\n";
     ss << "Deadlocks Prevented: " << deadlocksPrevented << "\n";
-    ss << "Method: Banker's Algorithm\n";
+    ss << "Method: Banker's Algorithm (incremental)\n";
+    ss << "Safety Checks: " << (fastPathChecks + fullChecks)
+       << " (" << fastPathChecks << " fast path, " << fullChecks << " full)\n";
     ss << "===============================================\n";
     return ss.str();
 }
\ No newline at end of file
@@ -30,6 +30,8 @@ MainWindow::MainWindow(QWidget *parent)
     , resourceManager(nullptr)
     , deadlockManager(nullptr)
     , scheduler(nullptr)
+    , haveUtilizationSample(false)
+    , lastLoggedPeakCPU(0)
 {
     if (!globalLogger) {
         globalLogger = new Logger();
@@ -273,7 +275,11 @@ QWidget* MainWindow::createConfigScreen()
     lblSched->setStyleSheet("color: #1a1a1a;");
     
     cmbScheduling = new QComboBox(screen);
-    cmbScheduling->addItems({"Priority Scheduling"});
+    cmbScheduling->addItem("Priority Scheduling", static_cast<int>(SchedulingAlgorithm::PRIORITY));
+    cmbScheduling->addItem("First-Come First-Served", static_cast<int>(SchedulingAlgorithm::FCFS));
+    cmbScheduling->addItem("Shortest Job First", static_cast<int>(SchedulingAlgorithm::SJF));
+    cmbScheduling->addItem("Round Robin", static_cast<int>(SchedulingAlgorithm::ROUND_ROBIN));
+    cmbScheduling->addItem("Multi-Level Feedback Queue", static_cast<int>(SchedulingAlgorithm::MLFQ));
     cmbScheduling->setMinimumWidth(280);
     cmbScheduling->setFont(spinFont);
     
@@ -570,7 +576,7 @@ QWidget* MainWindow::createResultsScreen()
     
     // Stats Group
     QGroupBox *statsGroup = new QGroupBox("📊 Results", contentWidget);
-    statsGroup->setMinimumHeight(520);
+    statsGroup->setMinimumHeight(600);
     QVBoxLayout *statsLayout = new QVBoxLayout(statsGroup);
     statsLayout->setSpacing(18);
     statsLayout->setContentsMargins(35, 45, 35, 35);
@@ -598,6 +604,14 @@ QWidget* MainWindow::createResultsScreen()
     lblFinalThroughput->setFont(statsFont);
     lblFinalThroughput->setStyleSheet("color: #1a1a1a;");
     
+    lblFinalWaitPercentiles = new QLabel("Wait p50/p95/p99/p99.9: -", contentWidget);
+    lblFinalWaitPercentiles->setFont(statsFont);
+    lblFinalWaitPercentiles->setStyleSheet("color: #1a1a1a;");
+    
+    lblFinalTurnaroundPercentiles = new QLabel("Turnaround p50/p95/p99/p99.9: -", contentWidget);
+    lblFinalTurnaroundPercentiles->setFont(statsFont);
+    lblFinalTurnaroundPercentiles->setStyleSheet("color: #1a1a1a;");
+    
     QFrame *sep1 = new QFrame(contentWidget);
     sep1->setFrameShape(QFrame::HLine);
     sep1->setStyleSheet("background-color: #bbb; min-height: 2px; margin: 10px 0;");
@@ -632,6 +646,8 @@ QWidget* MainWindow::createResultsScreen()
     statsLayout->addWidget(lblFinalAvgWaitTime);
     statsLayout->addWidget(lblFinalAvgTurnaroundTime);
     statsLayout->addWidget(lblFinalThroughput);
+    statsLayout->addWidget(lblFinalWaitPercentiles);
+    statsLayout->addWidget(lblFinalTurnaroundPercentiles);
     statsLayout->addWidget(sep1);
     statsLayout->addWidget(lblFinalCPUUtil);
     statsLayout->addWidget(lblFinalRAMUtil);
@@ -646,7 +662,7 @@ QWidget* MainWindow::createResultsScreen()
         QString("<p style='color: #1a1a1a; font-size: 14px; line-height: 1.7;'>"
                 "<b style='color: #1976D2;'>📁 Log Files Location:</b><br>"
                 "<code style='background: #e0e0e0; padding: 5px; border-radius: 4px;'>%1</code><br><br>"
-                "<b>Files:</b> system.log, job_*.log</p>").arg(logsPath),
+                "<b>Files:</b> system.log, job_summaries.*</p>").arg(logsPath),
         contentWidget
     );
     logInfo->setStyleSheet("padding: 20px; background: #E3F2FD; border-radius: 8px; border-left: 4px solid #1976D2;");
@@ -738,11 +754,13 @@ void MainWindow::showResultsScreen()
 void MainWindow::onStartSimulation()
 {
     int numJobs = spinJobCount->value();
+    SchedulingAlgorithm algorithm = static_cast<SchedulingAlgorithm>(cmbScheduling->currentData().toInt());
     
     QMessageBox msgBox(this);
     msgBox.setWindowTitle("Starting Simulation");
     msgBox.setText(QString("<h3 style='color: #1976D2;'>Starting Simulation</h3>"
-                          "<p style='color: #1a1a1a;'><b>Jobs:</b> %1</p>").arg(numJobs));
+                          "<p style='color: #1a1a1a;'><b>Jobs:</b> %1<br><b>Algorithm:</b> %2</p>")
+                          .arg(numJobs).arg(cmbScheduling->currentText()));
     msgBox.setStandardButtons(QMessageBox::Ok);
     msgBox.exec();
     
@@ -762,6 +780,9 @@ void MainWindow::onStartSimulation()
     lblThroughput->setText("⚡ Throughput: 0.00");
     lblDeadlocksPrevented->setText("🛡️ Deadlocks: 0");
     
+    haveUtilizationSample = false;
+    lastLoggedPeakCPU = 0;
+    
     isRunning = true;
     stopRequested = false;
     updateTimer->start(100);  // FASTER: Update every 100ms
@@ -769,7 +790,7 @@ void MainWindow::onStartSimulation()
     if (simulationThread.joinable()) {
         simulationThread.join();
     }
-    simulationThread = std::thread(&MainWindow::runSimulation, this, numJobs);
+    simulationThread = std::thread(&MainWindow::runSimulation, this, numJobs, algorithm);
 }
 
 void MainWindow::onStopSimulation()
@@ -801,15 +822,18 @@ void MainWindow::onViewLogs()
 }
 
 // ==================== SIMULATION - FIXED FOR REAL-TIME DISPLAY ====================
-void MainWindow::runSimulation(int numJobs)
+void MainWindow::runSimulation(int numJobs, SchedulingAlgorithm algorithm)
 {
     try {
         cleanupSimulation();
         addLogMessage("System", "Initializing...");
         
-        resourceManager = new ResourceManager(16, 64, 8, 4);
+        // Lock-free counters: the UI timer polls utilization while jobs allocate
+        resourceManager = new ResourceManager(16, 64, 8, 4, true);
         deadlockManager = new DeadlockManager(resourceManager);
         scheduler = new Scheduler(resourceManager, deadlockManager);
+        scheduler->setSchedulingPolicy(algorithm);
+        addLogMessage("System", QString("Scheduling policy: %1").arg(scheduler->getSchedulingPolicyName()));
         
         addLogMessage("System", QString("Creating %1 jobs...").arg(numJobs));
         
@@ -853,6 +877,7 @@ void MainWindow::runSimulation(int numJobs)
         
         if (!stopRequested) {
             addLogMessage("System", "Starting scheduling...");
+            resourceManager->resetUtilization();
             scheduler->scheduleAll();
             
             // Monitor jobs in real-time
@@ -921,25 +946,17 @@ void MainWindow::updateUI()
 {
     if (!resourceManager || !scheduler) return;
     
-    // Get PEAK resource usage (not instant)
-    static int peakCPU = 0, peakRAM = 0, peakDisk = 0, peakNet = 0;
-    
-    int cpu = static_cast<int>(resourceManager->getCPUUtilization());
-    int ram = static_cast<int>(resourceManager->getRAMUtilization());
-    int disk = static_cast<int>(resourceManager->getDiskUtilization());
-    int net = static_cast<int>(resourceManager->getNetworkUtilization());
-    
-    // Track peaks
-    if (cpu > peakCPU) peakCPU = cpu;
-    if (ram > peakRAM) peakRAM = ram;
-    if (disk > peakDisk) peakDisk = disk;
-    if (net > peakNet) peakNet = net;
-    
-    // Show peak values (they won't drop to 0 immediately)
-    cpuUsageBar->setValue(peakCPU);
-    ramUsageBar->setValue(peakRAM);
-    diskUsageBar->setValue(peakDisk);
-    networkUsageBar->setValue(peakNet);
+    // Time-weighted usage since the last tick, so short jobs still show
+    UtilizationSample sample = resourceManager->getUtilizationSample();
+    if (haveUtilizationSample && sample.time > lastUtilizationSample.time) {
+        QProgressBar* bars[4] = {cpuUsageBar, ramUsageBar, diskUsageBar, networkUsageBar};
+        for (size_t r = 0; r < 4; r++) {
+            double usage = resourceManager->getWindowUtilization(lastUtilizationSample, sample, r);
+            bars[r]->setValue(static_cast<int>(usage + 0.5));
+        }
+    }
+    lastUtilizationSample = sample;
+    haveUtilizationSample = true;
     
     int active = scheduler->getTotalJobs() - scheduler->getCompletedJobs();
     int completed = scheduler->getCompletedJobs();
@@ -957,11 +974,11 @@ void MainWindow::updateUI()
     lblDeadlocksPrevented->setText(QString("🛡️ Deadlocks: %1")
         .arg(deadlockManager->getDeadlocksPrevented()));
     
-    // Log high usage
-    static int lastLoggedCPU = 0;
-    if (peakCPU >= 50 && peakCPU != lastLoggedCPU && peakCPU % 25 == 0) {
+    // Log each new high-water mark from 50% up
+    int peakCPU = static_cast<int>(resourceManager->getPeakUtilization(0));
+    if (peakCPU >= 50 && peakCPU > lastLoggedPeakCPU) {
         addLogMessage("System", QString("CPU peak: %1%").arg(peakCPU));
-        lastLoggedCPU = peakCPU;
+        lastLoggedPeakCPU = peakCPU;
     }
 }
 
@@ -974,10 +991,28 @@ void MainWindow::displayFinalResults()
     lblFinalAvgWaitTime->setText(QString("Avg Wait: %1s").arg(scheduler->getAverageWaitingTime(), 0, 'f', 2));
     lblFinalAvgTurnaroundTime->setText(QString("Avg Turnaround: %1s").arg(scheduler->getAverageTurnaroundTime(), 0, 'f', 2));
     lblFinalThroughput->setText(QString("Throughput: %1 jobs/s").arg(scheduler->getThroughput(), 0, 'f', 2));
-    lblFinalCPUUtil->setText(QString("CPU: %1%").arg(resourceManager->getCPUUtilization(), 0, 'f', 2));
-    lblFinalRAMUtil->setText(QString("RAM: %1%").arg(resourceManager->getRAMUtilization(), 0, 'f', 2));
-    lblFinalDiskUtil->setText(QString("Disk: %1%").arg(resourceManager->getDiskUtilization(), 0, 'f', 2));
-    lblFinalNetworkUtil->setText(QString("Network: %1%").arg(resourceManager->getNetworkUtilization(), 0, 'f', 2));
+    
+    // Tail latency across all priorities
+    auto percentiles = [this](LatencyMetric metric) {
+        LatencyHistogram all;
+        scheduler->mergeLatencyHistograms(metric, all);
+        return QString("%1s / %2s / %3s / %4s")
+            .arg(all.getPercentile(50), 0, 'f', 2)
+            .arg(all.getPercentile(95), 0, 'f', 2)
+            .arg(all.getPercentile(99), 0, 'f', 2)
+            .arg(all.getPercentile(99.9), 0, 'f', 2);
+    };
+    lblFinalWaitPercentiles->setText("Wait p50/p95/p99/p99.9: " + percentiles(LatencyMetric::WAIT));
+    lblFinalTurnaroundPercentiles->setText("Turnaround p50/p95/p99/p99.9: " + percentiles(LatencyMetric::TURNAROUND));
+    
+    // Averaged over the run; everything has been released by now
+    QLabel* utilLabels[4] = {lblFinalCPUUtil, lblFinalRAMUtil, lblFinalDiskUtil, lblFinalNetworkUtil};
+    const char* utilNames[4] = {"CPU", "RAM", "Disk", "Network"};
+    for (size_t r = 0; r < 4; r++) {
+        utilLabels[r]->setText(QString("%1: %2% avg, %3% peak").arg(utilNames[r])
+            .arg(resourceManager->getAverageUtilization(r), 0, 'f', 2)
+            .arg(resourceManager->getPeakUtilization(r), 0, 'f', 2));
+    }
     lblFinalDeadlocksPrevented->setText(QString("Deadlocks Prevented: %1").arg(deadlockManager->getDeadlocksPrevented()));
 }
 
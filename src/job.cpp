@@ -13,65 +13,73 @@ Job::Job(int jobId, JobPriority prio, ResourceRequest needs,
          ResourceManager* rm, DeadlockManager* dm)
     : id(jobId), priority(prio), status(JobStatus::WAITING),
       resourceNeeds(needs), waitingTime(0), executionTime(0),
-      jobThread(nullptr), resourceManager(rm), deadlockManager(dm) {
+      simArrivalTime(0), simStartTime(0), resourceManager(rm), deadlockManager(dm), nodeId(-1),
+      fixedRuntimeMs(0) {
     
     arrivalTime = std::chrono::steady_clock::now();
     
-    std::string msg = "Arrived with priority=";
-    msg += getPriorityString();
-    msg += " requesting CPU:" + std::to_string(needs.cpuCores);
-    msg += " RAM:" + std::to_string(needs.ramGB) + "GB";
-    msg += " Disk:" + std::to_string(needs.diskSlots);
-    msg += " Network:" + std::to_string(needs.networkSlots);
-    
-    globalLogger->logJobEvent(id, msg);
-}
-
-Job::~Job() {
-    if (jobThread != nullptr) {
-        if (jobThread->joinable()) {
-            jobThread->join();
-        }
-        delete jobThread;
-    }
-}
-
-void Job::start() {
-    jobThread = new std::thread(&Job::run, this);
-}
-
-void Job::join() {
-    if (jobThread != nullptr && jobThread->joinable()) {
-        jobThread->join();
+    currentLogger()->traceEvent(TraceEventType::JOB_ARRIVED, id,
+        needs.cpuCores, needs.ramGB, needs.diskSlots, needs.networkSlots,
+        static_cast<uint16_t>(priority));
+    
+    if (currentLogger()->isEnabled()) {
+        std::string msg = "Arrived with priority=";
+        msg += getPriorityString();
+        msg += " requesting CPU:" + std::to_string(needs.cpuCores);
+        msg += " RAM:" + std::to_string(needs.ramGB) + "GB";
+        msg += " Disk:" + std::to_string(needs.diskSlots);
+        msg += " Network:" + std::to_string(needs.networkSlots);
+        
+        currentLogger()->logJobEvent(id, msg);
     }
 }
 
-void Job::run() {
-    // Wait for resources using Banker's Algorithm
-    status = JobStatus::WAITING;
-    globalLogger->logJobEvent(id, "Waiting for resources...");
-    
-    bool resourcesAllocated = false;
-    while (!resourcesAllocated) {
-        resourcesAllocated = deadlockManager->requestResources(id, resourceNeeds);
+bool Job::acquireResources(std::chrono::milliseconds timeout) {
+    bool allocated;
+    
+    // Banker's Algorithm decides whether the allocation is safe
+    if (status == JobStatus::WAITING) {
+        currentLogger()->traceEvent(TraceEventType::JOB_WAITING, id);
+        currentLogger()->logJobEvent(id, "Waiting for resources...");
+        unsigned long epoch = deadlockManager->getReleaseEpoch();
+        allocated = deadlockManager->requestResources(id, resourceNeeds);
         
-        if (!resourcesAllocated) {
+        if (!allocated) {
             status = JobStatus::BLOCKED;
-            globalLogger->logJobEvent(id, "BLOCKED - waiting for resources");
-            std::this_thread::sleep_for(std::chrono::milliseconds(500));
+            currentLogger()->traceEvent(TraceEventType::JOB_BLOCKED, id);
+            currentLogger()->logJobEvent(id, "BLOCKED - waiting for resources");
+            
+            // Sleep until a release can satisfy the request; the refusal
+            // above is not checked again before one
+            allocated = deadlockManager->acquire(id, resourceNeeds, timeout, epoch);
         }
+    } else {
+        allocated = deadlockManager->acquire(id, resourceNeeds, timeout);
+    }
+    
+    if (!allocated) {
+        return false;
     }
     
+    recordAdmitted();
+    return true;
+}
+
+void Job::recordAdmitted() {
     // Resources allocated, calculate waiting time
     startTime = std::chrono::steady_clock::now();
     auto waitDuration = std::chrono::duration_cast<std::chrono::milliseconds>(
         startTime - arrivalTime);
     waitingTime = waitDuration.count() / 1000.0;
-    
+}
+
+void Job::run() {
     // Start execution
     status = JobStatus::RUNNING;
-    std::string msg = "Started execution (waited " + std::to_string(waitingTime) + "s)";
-    globalLogger->logJobEvent(id, msg);
+    currentLogger()->traceEvent(TraceEventType::JOB_STARTED, id);
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(id, "Started execution (waited " + std::to_string(waitingTime) + "s)");
+    }
     
     // Execute the job
     executeTask();
@@ -83,41 +91,94 @@ void Job::run() {
     executionTime = execDuration.count() / 1000.0;
     
     status = JobStatus::COMPLETED;
-    msg = "Completed (execution time: " + std::to_string(executionTime) + "s)";
-    globalLogger->logJobEvent(id, msg);
+    currentLogger()->traceEvent(TraceEventType::JOB_COMPLETED, id);
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(id, "Completed (execution time: " + std::to_string(executionTime) + "s)");
+    }
     
     // Release resources
-    resourceManager->releaseResources(id);
+    deadlockManager->releaseResources(id);
     
     // Create job summary log
-    globalLogger->createJobLog(id, getSummary());
+    currentLogger()->createJobLog(id, getSummary());
+}
+
+void Job::assignNode(int node, ResourceManager* rm, DeadlockManager* dm) {
+    nodeId = node;
+    resourceManager = rm;
+    deadlockManager = dm;
+    
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(id, "Placed on node " + std::to_string(node));
+    }
 }
 
 void Job::executeTask() {
     // Simulate job execution with SLOWER timing for GUI visibility
-    int baseTime = 2000; // 2 seconds base
-    int resourceFactor = resourceNeeds.cpuCores * 250 + 
-                        resourceNeeds.ramGB * 150 +
-                        resourceNeeds.diskSlots * 200 +
-                        resourceNeeds.networkSlots * 150;
-    
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<> dis(-300, 300);
     
-    int sleepTime = baseTime + resourceFactor + dis(gen);
+    int sleepTime = getEstimatedRuntimeMs();
+    if (!hasFixedRuntime()) {
+        sleepTime += dis(gen);
+    }
     
-    // Phase 1: CPU
-    globalLogger->logJobEvent(id, "Phase 1: CPU computation");
-    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime / 3));
+    // Phase 1: CPU, Phase 2: Disk, Phase 3: Network
+    for (int phase = 1; phase <= 3; phase++) {
+        currentLogger()->traceEvent(TraceEventType::PHASE_STARTED, id, 0, 0, 0, 0,
+            static_cast<uint16_t>(phase));
+        currentLogger()->logJobEvent(id, getPhaseDescription(phase));
+        std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime / 3));
+    }
+}
+
+int Job::getEstimatedRuntimeMs() const {
+    if (fixedRuntimeMs > 0) {
+        return fixedRuntimeMs;
+    }
     
-    // Phase 2: Disk
-    globalLogger->logJobEvent(id, "Phase 2: Disk I/O operations");
-    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime / 3));
+    int baseTime = 2000; // 2 seconds base
+    int resourceFactor = resourceNeeds.cpuCores * 250 + 
+                        resourceNeeds.ramGB * 150 +
+                        resourceNeeds.diskSlots * 200 +
+                        resourceNeeds.networkSlots * 150;
+    return baseTime + resourceFactor;
+}
+
+const char* Job::getPhaseDescription(int phase) {
+    switch (phase) {
+        case 1: return "Phase 1: CPU computation";
+        case 2: return "Phase 2: Disk I/O operations";
+        case 3: return "Phase 3: Network data transfer";
+        default: return "Unknown phase";
+    }
+}
+
+void Job::recordSimulatedArrival(double now) {
+    simArrivalTime = now;
+    status = JobStatus::WAITING;
+}
+
+void Job::recordSimulatedStart(double now) {
+    simStartTime = now;
+    waitingTime = now - simArrivalTime;
+    status = JobStatus::RUNNING;
     
-    // Phase 3: Network
-    globalLogger->logJobEvent(id, "Phase 3: Network data transfer");
-    std::this_thread::sleep_for(std::chrono::milliseconds(sleepTime / 3));
+    currentLogger()->traceEvent(TraceEventType::JOB_STARTED, id);
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(id, "Started execution (waited " + std::to_string(waitingTime) + "s)");
+    }
+}
+
+void Job::recordSimulatedCompletion(double now) {
+    executionTime = now - simStartTime;
+    status = JobStatus::COMPLETED;
+    
+    currentLogger()->traceEvent(TraceEventType::JOB_COMPLETED, id);
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(id, "Completed (execution time: " + std::to_string(executionTime) + "s)");
+    }
 }
 
 const char* Job::getPriorityString() const {
@@ -144,6 +205,9 @@ std::string Job::getSummary() const {
     ss << std::fixed << std::setprecision(2);
     ss << "Job ID: " << id << "\n";
     ss << "Priority: " << getPriorityString() << "\n";
+    if (nodeId >= 0) {
+        ss << "Node: " << nodeId << "\n";
+    }
     ss << "Resources Used:\n";
     ss << "  - CPU Cores: " << resourceNeeds.cpuCores << "\n";
     ss << "  - RAM: " << resourceNeeds.ramGB << " GB\n";
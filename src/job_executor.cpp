@@ -0,0 +1,91 @@
+// ============================================
+// FILE: job_executor.cpp
+// DESCRIPTION: Implementation of the worker pool
+// ============================================
+
+#include "../include/job_executor.hpp"
+#include "../include/logger.hpp"
+
+JobExecutor::JobExecutor(unsigned int threadCount)
+    : activeTasks(0), stopping(false) {
+
+    if (threadCount == 0) {
+        threadCount = std::thread::hardware_concurrency();
+        if (threadCount == 0) threadCount = 2; // Not computable on this platform
+    }
+
+    workers.reserve(threadCount);
+    for (unsigned int i = 0; i < threadCount; i++) {
+        workers.emplace_back(&JobExecutor::workerLoop, this);
+    }
+
+    currentLogger()->logEvent("JobExecutor started with " +
+        std::to_string(threadCount) + " worker threads");
+}
+
+JobExecutor::~JobExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        stopping = true;
+    }
+    taskCV.notify_all();
+
+    // Workers drain the remaining tasks before exiting
+    for (std::thread& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
+
+void JobExecutor::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        tasks.push(std::move(task));
+    }
+    taskCV.notify_one();
+}
+
+void JobExecutor::waitForIdle() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    idleCV.wait(lock, [this]() { return tasks.empty() && activeTasks == 0; });
+}
+
+size_t JobExecutor::getPendingTasks() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return tasks.size();
+}
+
+int JobExecutor::getActiveTasks() {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    return activeTasks;
+}
+
+void JobExecutor::workerLoop() {
+    while (true) {
+        std::function<void()> task;
+
+        {
+            std::unique_lock<std::mutex> lock(queueMutex);
+            taskCV.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+            if (tasks.empty()) {
+                return; // Stopping and nothing left to run
+            }
+
+            task = std::move(tasks.front());
+            tasks.pop();
+            activeTasks++;
+        }
+
+        task();
+
+        {
+            std::lock_guard<std::mutex> lock(queueMutex);
+            activeTasks--;
+            if (tasks.empty() && activeTasks == 0) {
+                idleCV.notify_all();
+            }
+        }
+    }
+}
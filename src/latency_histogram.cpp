@@ -0,0 +1,134 @@
+// ============================================
+// FILE: latency_histogram.cpp
+// DESCRIPTION: Implementation of the log-linear latency histogram
+// ============================================
+
+#include "../include/latency_histogram.hpp"
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+static const uint64_t NO_MINIMUM = std::numeric_limits<uint64_t>::max();
+
+LatencyHistogram::LatencyHistogram(double resolution)
+    : ticksPerSecond(1.0 / resolution), count(0), totalTicks(0), minTicks(NO_MINIMUM), maxTicks(0) {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+size_t LatencyHistogram::bucketIndex(uint64_t ticks) {
+    if (ticks < SUB_BUCKET_COUNT) return static_cast<size_t>(ticks);
+
+    // The top SUB_BUCKET_BITS - 1 bits below the leading one pick the
+    // linear bucket within the value's power of two
+    int highestBit = 63;
+    while (!(ticks >> highestBit)) highestBit--;
+    int shift = highestBit - (SUB_BUCKET_BITS - 1);
+    size_t subBucket = static_cast<size_t>(ticks >> shift);
+    return SUB_BUCKET_COUNT + (shift - 1) * HALF_COUNT + (subBucket - HALF_COUNT);
+}
+
+uint64_t LatencyHistogram::bucketUpperBound(size_t index) {
+    if (index < SUB_BUCKET_COUNT) return index;
+
+    int shift = static_cast<int>((index - SUB_BUCKET_COUNT) / HALF_COUNT) + 1;
+    uint64_t subBucket = (index - SUB_BUCKET_COUNT) % HALF_COUNT + HALF_COUNT;
+    return ((subBucket + 1) << shift) - 1;
+}
+
+void LatencyHistogram::record(double seconds) {
+    double scaled = seconds * ticksPerSecond;
+    uint64_t ticks;
+    if (!(scaled > 0)) ticks = 0;
+    else if (scaled >= 1.8e19) ticks = std::numeric_limits<uint64_t>::max();
+    else ticks = static_cast<uint64_t>(std::llround(scaled));
+
+    buckets[bucketIndex(ticks)].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalTicks.fetch_add(ticks, std::memory_order_relaxed);
+
+    uint64_t seen = minTicks.load(std::memory_order_relaxed);
+    while (ticks < seen && !minTicks.compare_exchange_weak(seen, ticks, std::memory_order_relaxed)) {
+    }
+    seen = maxTicks.load(std::memory_order_relaxed);
+    while (ticks > seen && !maxTicks.compare_exchange_weak(seen, ticks, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        uint64_t n = other.buckets[i].load(std::memory_order_relaxed);
+        if (n > 0) buckets[i].fetch_add(n, std::memory_order_relaxed);
+    }
+    count.fetch_add(other.count.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    totalTicks.fetch_add(other.totalTicks.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
+    uint64_t otherMin = other.minTicks.load(std::memory_order_relaxed);
+    if (otherMin < minTicks.load(std::memory_order_relaxed)) minTicks.store(otherMin, std::memory_order_relaxed);
+    uint64_t otherMax = other.maxTicks.load(std::memory_order_relaxed);
+    if (otherMax > maxTicks.load(std::memory_order_relaxed)) maxTicks.store(otherMax, std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i].store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    totalTicks.store(0, std::memory_order_relaxed);
+    minTicks.store(NO_MINIMUM, std::memory_order_relaxed);
+    maxTicks.store(0, std::memory_order_relaxed);
+}
+
+double LatencyHistogram::getMin() const {
+    uint64_t ticks = minTicks.load(std::memory_order_relaxed);
+    return (ticks == NO_MINIMUM) ? 0.0 : ticks / ticksPerSecond;
+}
+
+double LatencyHistogram::getMax() const {
+    return maxTicks.load(std::memory_order_relaxed) / ticksPerSecond;
+}
+
+double LatencyHistogram::getMean() const {
+    uint64_t n = getCount();
+    if (n == 0) return 0.0;
+    return static_cast<double>(totalTicks.load(std::memory_order_relaxed)) / n / ticksPerSecond;
+}
+
+double LatencyHistogram::getSum() const {
+    return totalTicks.load(std::memory_order_relaxed) / ticksPerSecond;
+}
+
+uint64_t LatencyHistogram::getCountAtOrBelow(double seconds) const {
+    double bound = seconds * ticksPerSecond;
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT && bucketUpperBound(i) <= bound; i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+double LatencyHistogram::getPercentile(double percent) const {
+    // Counted from the buckets themselves, so a read during recording still
+    // sees a consistent total
+    uint64_t total = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        total += buckets[i].load(std::memory_order_relaxed);
+    }
+    if (total == 0) return 0.0;
+
+    double clamped = std::min(std::max(percent, 0.0), 100.0);
+    uint64_t rank = static_cast<uint64_t>(std::ceil(clamped / 100.0 * total));
+    if (rank == 0) rank = 1;
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BUCKET_COUNT; i++) {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen >= rank) {
+            // The bucket's top, but never past the largest recorded value
+            uint64_t value = std::min(bucketUpperBound(i), maxTicks.load(std::memory_order_relaxed));
+            return value / ticksPerSecond;
+        }
+    }
+    return getMax();
+}
@@ -0,0 +1,71 @@
+// ============================================
+// FILE: load_generator.cpp
+// DESCRIPTION: Implementation of the open-loop load generator
+// ============================================
+
+#include "../include/load_generator.hpp"
+#include "../include/logger.hpp"
+
+LoadGenerator::LoadGenerator(Scheduler* sched, JobSource* jobSource,
+                             ResourceManager* rm, DeadlockManager* dm)
+    : scheduler(sched), source(jobSource), resourceManager(rm), deadlockManager(dm),
+      stopping(false), generated(0) {
+}
+
+LoadGenerator::~LoadGenerator() {
+    stop();
+    join();
+}
+
+void LoadGenerator::start() {
+    if (generatorThread.joinable()) return;
+
+    startTime = std::chrono::steady_clock::now();
+    lastArrival = startTime;
+    generatorThread = std::thread(&LoadGenerator::run, this);
+}
+
+void LoadGenerator::join() {
+    if (generatorThread.joinable()) {
+        generatorThread.join();
+    }
+}
+
+void LoadGenerator::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        stopping = true;
+    }
+    stopCV.notify_all();
+}
+
+void LoadGenerator::run() {
+    currentLogger()->logEvent("LoadGenerator started");
+
+    JobSpec spec;
+    while (source->next(spec)) {
+        auto due = startTime + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+            std::chrono::duration<double>(spec.arrivalTime));
+
+        // Sleep until the arrival is due, waking early only to stop
+        {
+            std::unique_lock<std::mutex> lock(stopMutex);
+            if (stopCV.wait_until(lock, due, [this]() { return stopping; })) {
+                break;
+            }
+        }
+
+        Job* job = createJob(spec, resourceManager, deadlockManager);
+        scheduler->addJob(job);
+        generated++;
+        lastArrival = std::chrono::steady_clock::now();
+    }
+
+    currentLogger()->logEvent("LoadGenerator finished: " + std::to_string(generated) + " jobs offered");
+}
+
+double LoadGenerator::getOfferedRate() const {
+    double seconds = std::chrono::duration<double>(lastArrival - startTime).count();
+    if (seconds <= 0) return 0.0;
+    return generated / seconds;
+}
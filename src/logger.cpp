@@ -5,6 +5,9 @@
 
 #include "../include/logger.hpp"
 #include <chrono>
+#include <vector>
+#include <algorithm>
+#include <cmath>
 #include <sys/stat.h>
 #include <sys/types.h>
 
@@ -18,8 +21,18 @@
 
 // Global logger instance
 Logger* globalLogger = nullptr;
+thread_local Logger* threadLogger = nullptr;
 
-Logger::Logger() {
+Logger::Logger(LoggerOutput output)
+    : logMutex("Logger::logMutex"),
+      enabled(output == LoggerOutput::FILES), asyncMode(false), asyncProducers(0),
+      writerStopping(false),
+      overflowPolicy(OverflowPolicy::BLOCK), batchSize(256),
+      flushInterval(50), droppedRecords(0), reportedDrops(0),
+      traceFile(nullptr), tracing(false),
+      traceClock(nullptr), traceClockFrozen(false), traceFrozenTime(0) {
+    if (output == LoggerOutput::DETACHED) return;
+    
     std::cout << "[DEBUG] Inside Logger constructor...\n";
     std::cout.flush();
     
@@ -32,6 +45,8 @@ Logger::Logger() {
     std::cout << "[DEBUG] Logs directory created/verified\n";
     std::cout.flush();
     
+    summaryStore.reset(new JobSummaryStore("logs"));
+    
     // Open system log file
     systemLog.open("logs/system.log", std::ios::app);
     if (!systemLog.is_open()) {
@@ -45,6 +60,9 @@ Logger::Logger() {
 }
 
 Logger::~Logger() {
+    disableAsync();
+    closeTrace();
+    
     if (systemLog.is_open()) {
         logEvent("========== System Shutdown ==========\n");
         systemLog.close();
@@ -52,10 +70,13 @@ Logger::~Logger() {
 }
 
 std::string Logger::getCurrentTime() {
-    auto now = std::chrono::system_clock::now();
-    auto time = std::chrono::system_clock::to_time_t(now);
+    return formatTime(std::chrono::system_clock::now());
+}
+
+std::string Logger::formatTime(std::chrono::system_clock::time_point when) {
+    auto time = std::chrono::system_clock::to_time_t(when);
     auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-        now.time_since_epoch()) % 1000;
+        when.time_since_epoch()) % 1000;
     
     std::stringstream ss;
     ss << std::put_time(std::localtime(&time), "%Y-%m-%d %H:%M:%S");
@@ -65,7 +86,21 @@ std::string Logger::getCurrentTime() {
 }
 
 void Logger::logEvent(const std::string& message) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    if (!enabled) return;
+    
+    // Async mode: capture the time and hand off - no lock, no I/O. The
+    // producer count keeps disableAsync() from freeing the queue under us.
+    if (asyncMode) {
+        asyncProducers.fetch_add(1);
+        if (asyncMode) {
+            enqueueRecord({std::chrono::system_clock::now(), message});
+            asyncProducers.fetch_sub(1);
+            return;
+        }
+        asyncProducers.fetch_sub(1);
+    }
+    
+    ProfiledLockGuard lock(logMutex);
     
     std::string logMessage = "[" + getCurrentTime() + "] " + message;
     
@@ -80,20 +115,224 @@ void Logger::logEvent(const std::string& message) {
 }
 
 void Logger::logJobEvent(int jobId, const std::string& message) {
+    if (!enabled) return;
+    
     std::string formattedMessage = "Job " + std::to_string(jobId) + ": " + message;
     logEvent(formattedMessage);
 }
 
 void Logger::createJobLog(int jobId, const std::string& summary) {
-    std::lock_guard<std::mutex> lock(logMutex);
+    if (!enabled || !summaryStore) return;
+    
+    // One sequential append to the summary store - no per-job file
+    std::string record = "========== Job " + std::to_string(jobId) + " Summary ==========\n";
+    record += summary;
+    record += "\n============================================\n";
+    summaryStore->append(jobId, record);
+}
+
+void Logger::enableAsync(size_t capacity, OverflowPolicy policy, size_t batch,
+                         std::chrono::milliseconds interval) {
+    if (asyncMode) return;
+    
+    asyncQueue.reset(new MpmcRingBuffer<LogRecord>(capacity));
+    overflowPolicy = policy;
+    batchSize = batch > 0 ? batch : 1;
+    flushInterval = interval;
+    writerStopping = false;
+    
+    writerThread = std::thread(&Logger::writerLoop, this);
+    asyncMode = true;
+}
+
+void Logger::disableAsync() {
+    if (!asyncMode) return;
+    
+    // Producers that saw asyncMode before it cleared finish their push;
+    // the writer is still running, so a blocked push can complete
+    asyncMode = false;
+    while (asyncProducers.load() != 0) {
+        std::this_thread::yield();
+    }
+    
+    writerStopping = true;
+    writerCV.notify_one();
+    
+    // The writer drains everything still queued before exiting
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    asyncQueue.reset();
+}
+
+void Logger::enqueueRecord(LogRecord&& record) {
+    while (!asyncQueue->tryPush(std::move(record))) {
+        if (overflowPolicy != OverflowPolicy::BLOCK) {
+            droppedRecords++;
+            return;
+        }
+        
+        // Full - make sure the writer is awake, then retry
+        writerCV.notify_one();
+        std::this_thread::yield();
+    }
+    
+    // Wake the writer early once a full batch is waiting
+    if (asyncQueue->sizeApprox() >= batchSize) {
+        writerCV.notify_one();
+    }
+}
+
+void Logger::writerLoop() {
+    std::vector<LogRecord> batch;
+    batch.reserve(batchSize);
+    std::string text;
+    
+    size_t unflushed = 0;
+    auto lastFlush = std::chrono::steady_clock::now();
+    
+    while (true) {
+        batch.clear();
+        LogRecord record;
+        while (batch.size() < batchSize && asyncQueue->tryPop(record)) {
+            batch.push_back(std::move(record));
+        }
+        
+        unsigned long dropped = droppedRecords;
+        bool reportDrops = overflowPolicy == OverflowPolicy::COUNT_DROPS && dropped != reportedDrops;
+        
+        if (!batch.empty() || reportDrops) {
+            ProfiledLockGuard lock(logMutex);
+            
+            text.clear();
+            for (const LogRecord& r : batch) {
+                text += "[" + formatTime(r.timestamp) + "] " + r.message + "\n";
+            }
+            if (reportDrops) {
+                text += "[" + getCurrentTime() + "] Logger dropped " +
+                    std::to_string(dropped - reportedDrops) + " records (buffer full)\n";
+                reportedDrops = dropped;
+            }
+            
+            // One write per batch instead of one flushed write per line
+            if (systemLog.is_open()) {
+                systemLog << text;
+            }
+            std::cout << text;
+            unflushed += batch.size();
+        }
+        
+        auto now = std::chrono::steady_clock::now();
+        if (unflushed >= batchSize || (unflushed > 0 && now - lastFlush >= flushInterval)) {
+            ProfiledLockGuard lock(logMutex);
+            if (systemLog.is_open()) {
+                systemLog.flush();
+            }
+            std::cout.flush();
+            unflushed = 0;
+            lastFlush = now;
+        }
+        
+        if (batch.empty()) {
+            // Exit only once the queue has been drained
+            if (writerStopping) break;
+            
+            std::unique_lock<std::mutex> lock(writerMutex);
+            writerCV.wait_for(lock, flushInterval);
+        }
+    }
+    
+    ProfiledLockGuard lock(logMutex);
+    if (systemLog.is_open()) {
+        systemLog.flush();
+    }
+    std::cout.flush();
+}
+
+bool Logger::openTrace(const std::string& path) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    
+    if (traceFile != nullptr) return false;
+    
+    traceFile = std::fopen(path.c_str(), "wb");
+    if (traceFile == nullptr) {
+        std::cerr << "Error: Could not open trace file " << path << std::endl;
+        return false;
+    }
+    
+    // Large stdio buffer - records reach the disk in big sequential writes
+    std::setvbuf(traceFile, nullptr, _IOFBF, 1 << 20);
+    
+    writeTraceHeader();
+    
+    tracing = true;
+    return true;
+}
+
+void Logger::writeTraceHeader() {
+    TraceFileHeader header;
+    std::copy(TRACE_MAGIC, TRACE_MAGIC + sizeof(header.magic), header.magic);
+    header.version = TRACE_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.clockDomain = static_cast<uint32_t>(
+        (traceClock || traceClockFrozen) ? TraceClockDomain::SIMULATED : TraceClockDomain::WALL);
+    header.reserved = 0;
     
-    std::string filename = "logs/job_" + std::to_string(jobId) + ".log";
-    std::ofstream jobLog(filename);
+    // Rewritten in place when a simulator attaches after openTrace
+    std::fseek(traceFile, 0, SEEK_SET);
+    std::fwrite(&header, sizeof(header), 1, traceFile);
+    std::fseek(traceFile, 0, SEEK_END);
+}
+
+uint64_t Logger::traceTimestamp() const {
+    if (traceClock || traceClockFrozen) {
+        double now = traceClock ? traceClock->load(std::memory_order_relaxed) : traceFrozenTime;
+        return static_cast<uint64_t>(std::llround(now * 1e9));
+    }
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+void Logger::setSimulatedClock(const std::atomic<double>* clock) {
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (clock) {
+        traceClock = clock;
+        traceClockFrozen = false;
+        if (traceFile != nullptr) writeTraceHeader();
+    } else if (traceClock) {
+        traceFrozenTime = traceClock->load(std::memory_order_relaxed);
+        traceClockFrozen = true;
+        traceClock = nullptr;
+    }
+}
+
+void Logger::closeTrace() {
+    std::lock_guard<std::mutex> lock(traceMutex);
     
-    if (jobLog.is_open()) {
-        jobLog << "========== Job " << jobId << " Summary ==========" << std::endl;
-        jobLog << summary << std::endl;
-        jobLog << "============================================" << std::endl;
-        jobLog.close();
+    tracing = false;
+    if (traceFile != nullptr) {
+        std::fclose(traceFile);
+        traceFile = nullptr;
     }
-}
\ No newline at end of file
+}
+
+void Logger::traceEvent(TraceEventType type, int jobId,
+                        int cpu, int ram, int disk, int network, uint16_t aux) {
+    if (!tracing) return;
+    
+    TraceRecord record;
+    record.type = static_cast<uint16_t>(type);
+    record.aux = aux;
+    record.jobId = jobId;
+    record.resources[0] = cpu;
+    record.resources[1] = ram;
+    record.resources[2] = disk;
+    record.resources[3] = network;
+    
+    std::lock_guard<std::mutex> lock(traceMutex);
+    if (traceFile != nullptr) {
+        record.timestampNs = traceTimestamp();
+        std::fwrite(&record, sizeof(record), 1, traceFile);
+    }
+}
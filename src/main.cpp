@@ -8,9 +8,24 @@
 #include "../include/deadlock.hpp"
 #include "../include/scheduler.hpp"
 #include "../include/job.hpp"
+#include "../include/workload.hpp"
+#include "../include/event_simulator.hpp"
+#include "../include/cluster.hpp"
+#include "../include/load_generator.hpp"
+#include "../include/swf_source.hpp"
+#include "../include/simulation_runner.hpp"
+#include "../include/metrics.hpp"
+#include "../include/profiled_mutex.hpp"
 #include <iostream>
+#include <fstream>
+#include <sstream>
 #include <random>
 #include <iomanip>
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <algorithm>
+#include <cctype>
 
 void printHeader() {
     std::cout << "\n";
@@ -23,12 +38,15 @@ void printHeader() {
     std::cout << "\n";
 }
 
-void printSystemConfiguration(ResourceManager* rm) {
+void printSystemConfiguration(ResourceManager* rm, int numNodes = 0) {
     auto total = rm->getTotalResources();
     
     std::cout << "┌─────────────────────────────────────────────────────────┐\n";
     std::cout << "│ SYSTEM CONFIGURATION                                    │\n";
     std::cout << "├─────────────────────────────────────────────────────────┤\n";
+    if (numNodes > 0) {
+        std::cout << "│ Cluster Nodes:     " << std::setw(5) << numNodes << " (per-node resources below)   │\n";
+    }
     std::cout << "│ Total CPU Cores:     " << std::setw(3) << total.cpuCores << " cores                      │\n";
     std::cout << "│ Total RAM:           " << std::setw(3) << total.ramGB << " GB                        │\n";
     std::cout << "│ Total Disk Slots:    " << std::setw(3) << total.diskSlots << " slots                      │\n";
@@ -36,7 +54,8 @@ void printSystemConfiguration(ResourceManager* rm) {
     std::cout << "└─────────────────────────────────────────────────────────┘\n\n";
 }
 
-void printFinalReport(Scheduler* scheduler, ResourceManager* rm, DeadlockManager* dm) {
+void printFinalReport(Scheduler* scheduler, ResourceManager* rm, DeadlockManager* dm,
+                      Cluster* cluster) {
     std::cout << "\n";
     std::cout << "╔════════════════════════════════════════════════════════════╗\n";
     std::cout << "║                   SIMULATION COMPLETE                      ║\n";
@@ -44,66 +63,502 @@ void printFinalReport(Scheduler* scheduler, ResourceManager* rm, DeadlockManager
     
     std::cout << scheduler->getSchedulingReport();
     
+    if (cluster) {
+        std::cout << cluster->getClusterReport();
+        std::cout << "\n✅ All logs saved to 'logs/' directory\n";
+        std::cout << "✅ Job summaries stored in logs/job_summaries.* (read with datacenter_summary_dump)\n\n";
+        return;
+    }
+    
+    // Time-weighted over the run; every job has released by now
+    static const char* labels[4] = {"CPU Utilization:     ", "RAM Utilization:     ",
+                                    "Disk Utilization:    ", "Network Utilization: "};
     std::cout << "\n========== RESOURCE UTILIZATION ==========\n";
     std::cout << std::fixed << std::setprecision(2);
-    std::cout << "CPU Utilization:     " << rm->getCPUUtilization() << "%\n";
-    std::cout << "RAM Utilization:     " << rm->getRAMUtilization() << "%\n";
-    std::cout << "Disk Utilization:    " << rm->getDiskUtilization() << "%\n";
-    std::cout << "Network Utilization: " << rm->getNetworkUtilization() << "%\n";
+    for (size_t r = 0; r < 4; r++) {
+        std::cout << labels[r] << rm->getAverageUtilization(r) << "% average, "
+                  << rm->getPeakUtilization(r) << "% peak\n";
+    }
     std::cout << "==========================================\n";
     
     std::cout << dm->getSafetyReport();
     
     std::cout << "\n✅ All logs saved to 'logs/' directory\n";
-    std::cout << "✅ Individual job summaries available in logs/job_*.log\n\n";
+    std::cout << "✅ Job summaries stored in logs/job_summaries.* (read with datacenter_summary_dump)\n\n";
 }
 
 Job* generateRandomJob(int id, ResourceManager* rm, DeadlockManager* dm) {
     std::random_device rd;
     std::mt19937 gen(rd());
     
-    std::uniform_int_distribution<> prioDist(1, 3);
-    JobPriority priority = static_cast<JobPriority>(prioDist(gen));
+    JobSpec spec = makeRandomJobSpec(id, gen);
+    return new Job(id, spec.priority, spec.needs, rm, dm);
+}
+
+
+// --metrics-port / --metrics-file: where the run's metrics go, if anywhere
+struct MetricsOptions {
+    int port = 0;
+    std::string filePath;
+    double interval = 5.0;
+    
+    bool enabled() const { return port > 0 || !filePath.empty(); }
+};
+
+// Registers the run's objects and starts exporting; nullptr when metrics
+// are off. Stop (delete) the exporter before deleting any of the objects.
+static MetricsExporter* startMetrics(const MetricsOptions& options, MetricsRegistry& registry,
+                                     Scheduler* scheduler, ResourceManager* rm,
+                                     DeadlockManager* dm, Cluster* cluster,
+                                     EventSimulator* simulator = nullptr) {
+    if (!options.enabled()) return nullptr;
+    
+    scheduler->registerMetrics(registry);
+    if (cluster) {
+        cluster->registerMetrics(registry);
+    } else {
+        rm->registerMetrics(registry);
+        dm->registerMetrics(registry);
+    }
+    if (simulator) {
+        simulator->registerMetrics(registry);
+    }
+    
+    MetricsExporter* exporter = new MetricsExporter(&registry);
+    if (options.port > 0) {
+        if (exporter->startHttp(options.port)) {
+            std::cout << "Metrics: http://127.0.0.1:" << options.port << "/metrics\n";
+        } else {
+            std::cout << "Warning: Could not listen on port " << options.port << " for metrics\n";
+        }
+    }
+    if (!options.filePath.empty()) {
+        if (exporter->startFileDump(options.filePath, options.interval)) {
+            std::cout << "Metrics: written to " << options.filePath << " every "
+                      << options.interval << "s\n";
+        } else {
+            std::cout << "Warning: Could not write metrics to " << options.filePath << "\n";
+        }
+    }
+    return exporter;
+}
+
+static void printReplaySummary(const SimulationConfig& config, const SwfJobSource* trace) {
+    std::cout << "\n========== TRACE REPLAY ==========\n";
+    std::cout << "Trace: " << config.swfPath << "\n";
+    std::cout << "Jobs Replayed: " << trace->getProducedJobs() << "\n";
+    std::cout << "Skipped (never ran): " << trace->getSkippedJobs() << "\n";
+    std::cout << "Clamped to node limit: " << trace->getClampedJobs() << "\n";
+    if (trace->getMaxProcs() > 0) {
+        std::cout << "Trace Machine: " << trace->getMaxProcs() << " processors\n";
+    }
+    std::cout << "Time Scale: " << config.timeScale << "x\n";
+    std::cout << "==================================\n";
+}
+
+// Discrete-event mode: virtual clock, no sleeps, logging off
+int runDiscreteEvent(const SimulationConfig& config, const MetricsOptions& metrics) {
+    globalLogger = new Logger();
+    globalLogger->setEnabled(false);
+    if (!config.tracePath.empty()) {
+        globalLogger->openTrace(config.tracePath);
+    }
+    
+    ResourceManager resourceManager(config.capacity.cpuCores, config.capacity.ramGB,
+                                    config.capacity.diskSlots, config.capacity.networkSlots,
+                                    config.lockFree);
+    DeadlockManager deadlockManager(&resourceManager);
+    
+    Cluster* cluster;
+    Scheduler* scheduler = createScheduler(config, &resourceManager, &deadlockManager, cluster);
+    scheduler->setRetainCompletedJobs(false);
+    
+    printSystemConfiguration(&resourceManager, config.numNodes);
+    SwfJobSource* trace;
+    JobSource* source = createJobSource(config, config.numJobs, &deadlockManager, trace);
+    if (!source) {
+        std::cout << "Error: Could not open trace " << config.swfPath << "\n";
+        delete scheduler;
+        delete cluster;
+        delete globalLogger;
+        return 1;
+    }
+    if (trace) {
+        std::cout << "Replaying " << config.swfPath << "...\n";
+    } else {
+        std::cout << "Simulating " << config.numJobs << " jobs (seed " << config.seed << ")...\n";
+    }
+    std::cout.flush();
+    
+    EventSimulator* simulator = cluster
+        ? new EventSimulator(cluster, scheduler, source, config.seed)
+        : new EventSimulator(&resourceManager, &deadlockManager, scheduler, source, config.seed);
+    
+    MetricsRegistry registry;
+    MetricsExporter* exporter = startMetrics(metrics, registry, scheduler, &resourceManager,
+                                             &deadlockManager, cluster, simulator);
+    
+    auto startTime = std::chrono::steady_clock::now();
+    simulator->run();
+    auto endTime = std::chrono::steady_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime);
+    
+    // The final file dump reflects the finished run
+    delete exporter;
+    
+    std::cout << scheduler->getSchedulingReport();
+    if (cluster) {
+        std::cout << cluster->getClusterReport();
+    } else {
+        std::cout << deadlockManager.getSafetyReport();
+    }
+    std::cout << simulator->getSimulationReport();
+    if (trace) {
+        printReplaySummary(config, trace);
+    }
+    std::cout << "Wall-clock Time: " << duration.count() << " ms\n\n";
+    std::cout << getLockContentionReport();
+    
+    delete simulator;
+    delete source;
+    delete scheduler;
+    delete cluster;
+    delete globalLogger;
+    return 0;
+}
+
+// Online mode: real threads and sleeps, with jobs arriving on the wall
+// clock from an open-loop generator while the dispatcher runs. Logging is
+// off so the admission path is what gets measured.
+int runOnline(const SimulationConfig& config, const MetricsOptions& metrics) {
+    globalLogger = new Logger();
+    globalLogger->setEnabled(false);
+    if (!config.tracePath.empty()) {
+        globalLogger->openTrace(config.tracePath);
+    }
+    
+    ResourceManager resourceManager(config.capacity.cpuCores, config.capacity.ramGB,
+                                    config.capacity.diskSlots, config.capacity.networkSlots,
+                                    config.lockFree);
+    DeadlockManager deadlockManager(&resourceManager);
+    
+    Cluster* cluster;
+    Scheduler* scheduler = createScheduler(config, &resourceManager, &deadlockManager, cluster);
+    scheduler->setRetainCompletedJobs(false);
+    
+    printSystemConfiguration(&resourceManager, config.numNodes);
+    SwfJobSource* trace;
+    JobSource* source = createJobSource(config, config.numJobs, &deadlockManager, trace);
+    if (!source) {
+        std::cout << "Error: Could not open trace " << config.swfPath << "\n";
+        delete scheduler;
+        delete cluster;
+        delete globalLogger;
+        return 1;
+    }
+    if (trace) {
+        std::cout << "Replaying " << config.swfPath << " online at " << config.timeScale << "x...\n";
+    } else {
+        double rate = (config.arrivalRate > 0) ? config.arrivalRate : 10.0;
+        std::cout << "Offering " << config.numJobs << " jobs online: "
+                  << getArrivalProcessName(config.arrivals)
+                  << ", " << rate << " jobs/s (seed " << config.seed << ")...\n";
+    }
+    std::cout.flush();
+    
+    // Cluster jobs get their node's managers at placement
+    LoadGenerator* generator = cluster
+        ? new LoadGenerator(scheduler, source, nullptr, nullptr)
+        : new LoadGenerator(scheduler, source, &resourceManager, &deadlockManager);
+    
+    MetricsRegistry registry;
+    MetricsExporter* exporter = startMetrics(metrics, registry, scheduler, &resourceManager,
+                                             &deadlockManager, cluster);
+    
+    auto startTime = std::chrono::steady_clock::now();
+    scheduler->startOnline();
+    generator->start();
+    generator->join();
+    scheduler->closeArrivals();
+    scheduler->waitForAllJobs();
+    auto endTime = std::chrono::steady_clock::now();
+    delete exporter;
+    double seconds = std::chrono::duration<double>(endTime - startTime).count();
+    
+    std::cout << scheduler->getSchedulingReport();
+    if (cluster) {
+        std::cout << cluster->getClusterReport();
+    } else {
+        std::cout << deadlockManager.getSafetyReport();
+    }
     
-    std::uniform_int_distribution<> cpuDist(1, 4);
-    std::uniform_int_distribution<> ramDist(2, 16);
-    std::uniform_int_distribution<> diskDist(1, 3);
-    std::uniform_int_distribution<> netDist(1, 2);
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n========== ONLINE LOAD ==========\n";
+    std::cout << "Offered Load: " << generator->getOfferedRate() << " jobs/second ("
+              << generator->getGeneratedJobs() << " jobs)\n";
+    std::cout << "Achieved Throughput: " << scheduler->getCompletedJobs() / seconds << " jobs/second\n";
+    std::cout << "Wall-clock Time: " << seconds << " seconds\n";
+    std::cout << "=================================\n";
+    if (trace) {
+        printReplaySummary(config, trace);
+    }
+    std::cout << "\n";
+    std::cout << getLockContentionReport();
+    
+    delete generator;
+    delete source;
+    delete scheduler;
+    delete cluster;
+    delete globalLogger;
+    return 0;
+}
+
+static std::vector<std::string> splitList(const std::string& value) {
+    std::vector<std::string> values;
+    std::stringstream ss(value);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        values.push_back(item);
+    }
+    if (values.empty()) values.push_back(value);
+    return values;
+}
+
+// Sweep mode: every setting may be a comma-separated list, and every
+// combination runs as its own discrete-event simulation, in parallel.
+// One CSV row per combination goes to stdout or the output file.
+int runSweepMode(const std::vector<std::pair<std::string, std::string>>& settings,
+                 unsigned int threads, const std::string& outputPath) {
+    // Later settings replace earlier ones with the same key
+    std::vector<std::string> columns;
+    std::vector<std::vector<std::string>> values;
+    for (const auto& setting : settings) {
+        if (setting.first == "trace") {
+            std::cerr << "Error: --trace cannot be used in a sweep\n";
+            return 1;
+        }
+        
+        std::vector<std::string> list = splitList(setting.second);
+        SimulationConfig check;
+        for (const std::string& value : list) {
+            if (!applySetting(check, setting.first, value)) {
+                std::cerr << "Error: Invalid value '" << value << "' for " << setting.first << "\n";
+                return 1;
+            }
+        }
+        
+        auto existing = std::find(columns.begin(), columns.end(), setting.first);
+        if (existing != columns.end()) {
+            values[existing - columns.begin()] = list;
+        } else {
+            columns.push_back(setting.first);
+            values.push_back(list);
+        }
+    }
     
-    int cpuMultiplier = (priority == JobPriority::HIGH) ? 2 : 1;
+    // Cartesian product, last column varying fastest
+    std::vector<SweepPoint> points;
+    std::vector<size_t> digits(columns.size(), 0);
+    while (true) {
+        SweepPoint point;
+        for (size_t c = 0; c < columns.size(); c++) {
+            applySetting(point.config, columns[c], values[c][digits[c]]);
+            point.settings.push_back(values[c][digits[c]]);
+        }
+        points.push_back(point);
+        
+        size_t c = columns.size();
+        while (c > 0 && ++digits[c - 1] == values[c - 1].size()) {
+            digits[c - 1] = 0;
+            c--;
+        }
+        if (c == 0) break;
+    }
     
-    ResourceRequest needs(
-        cpuDist(gen) * cpuMultiplier,
-        ramDist(gen),
-        diskDist(gen),
-        netDist(gen)
-    );
+    // Every run logs through its own detached logger, so nothing but the
+    // CSV reaches stdout
+    std::ofstream file;
+    if (!outputPath.empty()) {
+        file.open(outputPath);
+        if (!file.is_open()) {
+            std::cerr << "Error: Could not write " << outputPath << "\n";
+            return 1;
+        }
+    }
     
-    return new Job(id, priority, needs, rm, dm);
+    runSweep(columns, points, threads, file.is_open() ? static_cast<std::ostream&>(file) : std::cout);
+    return 0;
 }
 
-int main() {
+static void printEstimate(const char* label, const Estimate& estimate, const char* unit) {
+    std::cout << label << estimate.mean << " ± " << estimate.halfWidth << unit << "\n";
+}
+
+// Replication mode: the discrete-event run repeated with seeds seed,
+// seed + 1, ... in parallel, reported as means with 95% confidence
+// intervals across the runs
+int runReplicationMode(const SimulationConfig& config, int replications, unsigned int threads) {
+    if (!config.tracePath.empty()) {
+        std::cout << "Error: --trace cannot be used with --replications\n";
+        return 1;
+    }
+    
+    std::cout << "Running " << replications << " replications of " << config.numJobs
+              << " jobs (seeds " << config.seed << "-" << config.seed + replications - 1 << ")...\n";
+    std::cout.flush();
+    
+    ReplicationSummary summary;
+    if (!runReplications(config, replications, threads, summary)) {
+        std::cout << "Error: Could not open trace " << config.swfPath << "\n";
+        return 1;
+    }
+    
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\n========== MONTE CARLO REPLICATIONS ==========\n";
+    std::cout << "Replications: " << summary.replications << " (95% confidence intervals)\n";
+    printEstimate("Average Waiting Time: ", summary.averageWaitingTime, " seconds");
+    printEstimate("Average Turnaround Time: ", summary.averageTurnaroundTime, " seconds");
+    printEstimate("Makespan: ", summary.makespan, " seconds");
+    std::cout << std::setprecision(4);
+    printEstimate("Throughput: ", summary.throughput, " jobs/second");
+    std::cout << std::setprecision(2);
+    printEstimate("CPU Utilization:     ", summary.utilization[0], "%");
+    printEstimate("RAM Utilization:     ", summary.utilization[1], "%");
+    printEstimate("Disk Utilization:    ", summary.utilization[2], "%");
+    printEstimate("Network Utilization: ", summary.utilization[3], "%");
+    std::cout << "Wall-clock Time: " << summary.wallSeconds << " seconds\n";
+    std::cout << "==============================================\n\n";
+    return 0;
+}
+
+// Flags that take a value, named as the SimulationConfig keys
+static bool isValueSetting(const std::string& key) {
+    static const char* keys[] = {
+        "trace", "cpu", "ram", "disk", "network", "nodes", "placement", "policy",
+        "arrivals", "rate", "swf", "time-scale", "jobs", "seed"
+    };
+    for (const char* name : keys) {
+        if (key == name) return true;
+    }
+    return false;
+}
+
+int main(int argc, char* argv[]) {
+    // Usage: datacenter_console [--config <file>] [--trace <file>] [--lock-free]
+    //                           [--cpu <n>] [--ram <gb>] [--disk <n>] [--network <n>]
+    //                           [--nodes <n>] [--placement first|next|best]
+    //                           [--policy priority|fcfs|sjf|rr|mlfq]
+    //                           [--backfill [depth]]
+    //                           [--arrivals constant|poisson|mmpp] [--rate <jobs/s>]
+    //                           [--swf <trace>] [--time-scale <x>]
+    //                           [--jobs <n>] [--seed <n>]
+    //                           [--des [jobs] [seed] [--replications <k>] |
+    //                            --online [jobs] [seed] |
+    //                            --sweep [--output <file>]] [--threads <n>]
+    //                           [--metrics-port <port>] [--metrics-file <file>]
+    //                           [--metrics-interval <seconds>]
+    //
+    // A config file holds the same settings as "key = value" lines, plus
+    // mode (des, online, sweep), replications, threads, output and the
+    // metrics options. Metrics cover single runs, not sweeps or replications.
+    std::vector<std::pair<std::string, std::string>> settings;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        std::string key = (arg.compare(0, 2, "--") == 0) ? arg.substr(2) : "";
+        if (key == "config" && i + 1 < argc) {
+            if (!loadConfigFile(argv[++i], settings)) {
+                std::cerr << "Error: Could not read config file " << argv[i] << "\n";
+                return 1;
+            }
+        } else if (key == "lock-free") {
+            settings.push_back({"lock-free", "1"});
+        } else if (key == "backfill") {
+            std::string depth = std::to_string(Scheduler::DEFAULT_BACKFILL_DEPTH);
+            if (i + 1 < argc && std::isdigit(static_cast<unsigned char>(argv[i + 1][0]))) {
+                depth = argv[++i];
+            }
+            settings.push_back({"backfill", depth});
+        } else if ((key == "threads" || key == "output" || key == "replications" ||
+                    key.compare(0, 8, "metrics-") == 0 || isValueSetting(key)) && i + 1 < argc) {
+            settings.push_back({key, argv[++i]});
+        } else {
+            args.push_back(arg);
+        }
+    }
+    
+    // Mode: --des/--online/--sweep, else the config file's, else interactive
+    std::string mode;
+    unsigned int sweepThreads = 0;
+    int replications = 1;
+    std::string outputPath;
+    MetricsOptions metrics;
+    std::vector<std::pair<std::string, std::string>> simulationSettings;
+    for (const auto& setting : settings) {
+        if (setting.first == "mode") mode = setting.second;
+        else if (setting.first == "threads") sweepThreads = static_cast<unsigned int>(std::max(0, std::atoi(setting.second.c_str())));
+        else if (setting.first == "output") outputPath = setting.second;
+        else if (setting.first == "replications") replications = std::max(1, std::atoi(setting.second.c_str()));
+        else if (setting.first == "metrics-port") metrics.port = std::atoi(setting.second.c_str());
+        else if (setting.first == "metrics-file") metrics.filePath = setting.second;
+        else if (setting.first == "metrics-interval") metrics.interval = std::atof(setting.second.c_str());
+        else simulationSettings.push_back(setting);
+    }
+    if (!args.empty() && (args[0] == "--des" || args[0] == "--online" || args[0] == "--sweep")) {
+        mode = args[0].substr(2);
+        
+        // Positional [jobs] [seed] after --des and --online
+        if (mode != "sweep" && args.size() > 1) simulationSettings.push_back({"jobs", args[1]});
+        if (mode != "sweep" && args.size() > 2) simulationSettings.push_back({"seed", args[2]});
+    }
+    
+    if (mode == "sweep") {
+        return runSweepMode(simulationSettings, sweepThreads, outputPath);
+    }
+    
     printHeader();
     
+    SimulationConfig config;
+    for (const auto& setting : simulationSettings) {
+        if (!applySetting(config, setting.first, setting.second)) {
+            std::cout << "Ignoring invalid " << setting.first << " '" << setting.second << "'\n";
+        }
+    }
+    
+    if (mode == "des" || mode == "online") {
+        bool online = (mode == "online");
+        
+        // A trace is replayed in full unless a job count is given
+        if (config.numJobs < 1 && config.swfPath.empty()) config.numJobs = online ? 200 : 1000;
+        if (!online && replications > 1) {
+            return runReplicationMode(config, replications, sweepThreads);
+        }
+        return online ? runOnline(config, metrics) : runDiscreteEvent(config, metrics);
+    }
+    
+    // With a job count the threaded run is scripted: seeded jobs, no
+    // prompts and no size limit
+    bool interactive = (config.numJobs < 1);
+    
     std::cout << "Initializing Data Center Simulation...\n\n";
     std::cout << "[DEBUG] Step 1: Creating logger...\n";
     std::cout.flush();
     
     // Create global logger
     globalLogger = new Logger();
+    if (!config.tracePath.empty()) {
+        globalLogger->openTrace(config.tracePath);
+    }
     
     std::cout << "[DEBUG] Logger created successfully\n";
     std::cout.flush();
     
-    const int TOTAL_CPU = 16;
-    const int TOTAL_RAM = 64;
-    const int TOTAL_DISK = 8;
-    const int TOTAL_NETWORK = 4;
-    
     std::cout << "[DEBUG] Step 2: Creating ResourceManager...\n";
     std::cout.flush();
     
-    ResourceManager resourceManager(TOTAL_CPU, TOTAL_RAM, TOTAL_DISK, TOTAL_NETWORK);
+    ResourceManager resourceManager(config.capacity.cpuCores, config.capacity.ramGB,
+                                    config.capacity.diskSlots, config.capacity.networkSlots,
+                                    config.lockFree);
     
     std::cout << "[DEBUG] Step 3: Creating DeadlockManager...\n";
     std::cout.flush();
@@ -113,30 +568,54 @@ int main() {
     std::cout << "[DEBUG] Step 4: Creating Scheduler...\n";
     std::cout.flush();
     
-    Scheduler scheduler(&resourceManager, &deadlockManager);
+    Cluster* cluster;
+    Scheduler* scheduler = createScheduler(config, &resourceManager, &deadlockManager, cluster);
     
     std::cout << "[DEBUG] Initialization complete!\n\n";
     std::cout.flush();
     
-    printSystemConfiguration(&resourceManager);
-    
-    int numJobs;
-    std::cout << "Enter number of jobs to simulate (recommended: 10-20): ";
-    std::cout.flush();
-    std::cin >> numJobs;
-    
-    if (numJobs < 1 || numJobs > 100) {
-        std::cout << "Invalid input. Using default: 15 jobs\n";
-        numJobs = 15;
+    printSystemConfiguration(&resourceManager, config.numNodes);
+    
+    int numJobs = config.numJobs;
+    if (interactive) {
+        std::cout << "Enter number of jobs to simulate (recommended: 10-20): ";
+        std::cout.flush();
+        std::cin >> numJobs;
+        
+        if (numJobs < 1 || numJobs > 100) {
+            std::cout << "Invalid input. Using default: 15 jobs\n";
+            numJobs = 15;
+        }
     }
     
     std::cout << "\nGenerating " << numJobs << " jobs...\n";
     std::cout << "────────────────────────────────────────────────────────────\n\n";
     std::cout.flush();
     
-    for (int i = 1; i <= numJobs; i++) {
-        Job* job = generateRandomJob(i, &resourceManager, &deadlockManager);
-        scheduler.addJob(job);
+    // Cluster jobs get their node's managers at placement
+    ResourceManager* jobRm = cluster ? nullptr : &resourceManager;
+    DeadlockManager* jobDm = cluster ? nullptr : &deadlockManager;
+    if (interactive) {
+        for (int i = 1; i <= numJobs; i++) {
+            scheduler->addJob(generateRandomJob(i, jobRm, jobDm));
+        }
+    } else {
+        SwfJobSource* trace;
+        JobSource* source = createJobSource(config, numJobs, &deadlockManager, trace);
+        if (!source) {
+            std::cout << "Error: Could not open trace " << config.swfPath << "\n";
+            delete scheduler;
+            delete cluster;
+            delete globalLogger;
+            return 1;
+        }
+        JobSpec spec;
+        numJobs = 0;
+        while (source->next(spec)) {
+            scheduler->addJob(createJob(spec, jobRm, jobDm));
+            numJobs++;
+        }
+        delete source;
     }
     
     std::cout << "\n" << numJobs << " jobs created and added to scheduler\n";
@@ -144,23 +623,44 @@ int main() {
     std::cout << "════════════════════════════════════════════════════════════\n\n";
     std::cout.flush();
     
+    // Job threads hand log lines to a background writer while jobs run
+    globalLogger->enableAsync();
+    
+    MetricsRegistry registry;
+    MetricsExporter* exporter = startMetrics(metrics, registry, scheduler, &resourceManager,
+                                             &deadlockManager, cluster);
+    
+    // Utilization is averaged over the run, not the set-up and prompts
+    if (cluster) {
+        cluster->resetUtilization();
+    } else {
+        resourceManager.resetUtilization();
+    }
     auto startTime = std::chrono::steady_clock::now();
     
-    scheduler.scheduleAll();
-    scheduler.waitForAllJobs();
+    scheduler->scheduleAll();
+    scheduler->waitForAllJobs();
     
     auto endTime = std::chrono::steady_clock::now();
+    
+    globalLogger->disableAsync();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(endTime - startTime);
     
-    printFinalReport(&scheduler, &resourceManager, &deadlockManager);
+    printFinalReport(scheduler, &resourceManager, &deadlockManager, cluster);
     
     std::cout << "Total Simulation Time: " << duration.count() << " seconds\n\n";
+    std::cout << getLockContentionReport();
     
-    std::cout << "Press Enter to exit...";
-    std::cin.ignore();
-    std::cin.get();
+    if (interactive) {
+        std::cout << "Press Enter to exit...";
+        std::cin.ignore();
+        std::cin.get();
+    }
     
+    delete exporter;
+    delete scheduler;
+    delete cluster;
     delete globalLogger;
     
     return 0;
-}
\ No newline at end of file
+}
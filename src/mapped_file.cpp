@@ -0,0 +1,86 @@
+// ============================================
+// FILE: mapped_file.cpp
+// DESCRIPTION: Implementation of the read-only file mapping
+// ============================================
+
+#include "../include/mapped_file.hpp"
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <fcntl.h>
+    #include <unistd.h>
+#endif
+
+MappedFile::MappedFile() : data(nullptr), size(0), released(0) {
+#ifdef _WIN32
+    file = INVALID_HANDLE_VALUE;
+    mapping = nullptr;
+#else
+    fd = -1;
+#endif
+}
+
+MappedFile::~MappedFile() {
+#ifdef _WIN32
+    if (data) UnmapViewOfFile(data);
+    if (mapping) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+#else
+    if (data) munmap(const_cast<unsigned char*>(data), size);
+    if (fd >= 0) close(fd);
+#endif
+}
+
+bool MappedFile::open(const char* path) {
+#ifdef _WIN32
+    file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                       OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(file, &fileSize)) return false;
+    size = static_cast<size_t>(fileSize.QuadPart);
+    if (size == 0) return true;
+
+    mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) return false;
+    data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    return data != nullptr;
+#else
+    fd = ::open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0) return false;
+    size = static_cast<size_t>(info.st_size);
+    if (size == 0) return true;
+
+    void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapped == MAP_FAILED) return false;
+    madvise(mapped, size, MADV_SEQUENTIAL);
+    data = static_cast<const unsigned char*>(mapped);
+    return true;
+#endif
+}
+
+void MappedFile::release(size_t offset) {
+#ifdef _WIN32
+    // The working set trims itself; nothing to do
+    (void)offset;
+#else
+    if (!data) return;
+
+    // Whole pages only: the page holding offset may still be read
+    size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    size_t end = (offset < size ? offset : size) / pageSize * pageSize;
+    if (end <= released) return;
+
+    madvise(const_cast<unsigned char*>(data) + released, end - released, MADV_DONTNEED);
+    released = end;
+#endif
+}
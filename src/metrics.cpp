@@ -0,0 +1,296 @@
+// ============================================
+// FILE: metrics.cpp
+// DESCRIPTION: Implementation of the metrics registry and exporter
+// ============================================
+
+#include "../include/metrics.hpp"
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <poll.h>
+#endif
+
+#ifndef MSG_NOSIGNAL
+#define MSG_NOSIGNAL 0
+#endif
+
+// Upper bounds of the exported histogram buckets, in seconds: from the
+// threaded mode's milliseconds to the simulator's days-long waits
+static const double HISTOGRAM_BOUNDS[] = {
+    0.001, 0.005, 0.01, 0.05, 0.1, 0.5, 1, 5, 10, 50, 100, 500,
+    1000, 5000, 10000, 50000, 100000, 500000, 1000000
+};
+
+static const char* typeName(MetricType type) {
+    switch (type) {
+        case MetricType::COUNTER: return "counter";
+        case MetricType::GAUGE: return "gauge";
+        case MetricType::HISTOGRAM: return "histogram";
+    }
+    return "untyped";
+}
+
+static std::string formatValue(double value) {
+    if (std::isnan(value)) return "NaN";
+    if (std::isinf(value)) return value > 0 ? "+Inf" : "-Inf";
+
+    std::ostringstream ss;
+    if (value == std::floor(value) && std::fabs(value) < 1e15) {
+        ss << static_cast<long long>(value);
+    } else {
+        ss << std::setprecision(15) << value;
+    }
+    return ss.str();
+}
+
+static std::string withLabels(const std::string& labels, const std::string& extra = "") {
+    if (labels.empty() && extra.empty()) return "";
+    if (labels.empty()) return "{" + extra + "}";
+    if (extra.empty()) return "{" + labels + "}";
+    return "{" + labels + "," + extra + "}";
+}
+
+MetricsRegistry::~MetricsRegistry() {
+    for (MetricCounter* counter : ownedCounters) {
+        delete counter;
+    }
+}
+
+MetricsRegistry::Family& MetricsRegistry::family(const std::string& name, const std::string& help,
+                                                 MetricType type) {
+    // Series with the same name share one HELP/TYPE header
+    for (Family& existing : families) {
+        if (existing.name == name) return existing;
+    }
+    families.push_back({name, help, type, {}});
+    return families.back();
+}
+
+MetricCounter* MetricsRegistry::addCounter(const std::string& name, const std::string& help,
+                                           const std::string& labels) {
+    MetricCounter* counter = new MetricCounter();
+    std::lock_guard<std::mutex> lock(registryMutex);
+    ownedCounters.push_back(counter);
+    family(name, help, MetricType::COUNTER).series.push_back(
+        {labels, [counter]() { return static_cast<double>(counter->get()); }, nullptr});
+    return counter;
+}
+
+void MetricsRegistry::addCounterFunction(const std::string& name, const std::string& help,
+                                         const std::string& labels, std::function<double()> read) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    family(name, help, MetricType::COUNTER).series.push_back({labels, read, nullptr});
+}
+
+void MetricsRegistry::addGaugeFunction(const std::string& name, const std::string& help,
+                                       const std::string& labels, std::function<double()> read) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    family(name, help, MetricType::GAUGE).series.push_back({labels, read, nullptr});
+}
+
+void MetricsRegistry::addHistogram(const std::string& name, const std::string& help,
+                                   const std::string& labels, const LatencyHistogram* histogram) {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    family(name, help, MetricType::HISTOGRAM).series.push_back({labels, nullptr, histogram});
+}
+
+std::string MetricsRegistry::render() const {
+    std::lock_guard<std::mutex> lock(registryMutex);
+    std::ostringstream out;
+
+    for (const Family& f : families) {
+        out << "# HELP " << f.name << ' ' << f.help << '\n';
+        out << "# TYPE " << f.name << ' ' << typeName(f.type) << '\n';
+
+        for (const Series& series : f.series) {
+            if (f.type != MetricType::HISTOGRAM) {
+                out << f.name << withLabels(series.labels) << ' ' << formatValue(series.read()) << '\n';
+                continue;
+            }
+
+            const LatencyHistogram* histogram = series.histogram;
+            uint64_t count = histogram->getCount();
+            for (double bound : HISTOGRAM_BOUNDS) {
+                out << f.name << "_bucket"
+                    << withLabels(series.labels, "le=\"" + formatValue(bound) + "\"") << ' '
+                    << std::min(histogram->getCountAtOrBelow(bound), count) << '\n';
+            }
+            out << f.name << "_bucket" << withLabels(series.labels, "le=\"+Inf\"") << ' ' << count << '\n';
+            out << f.name << "_sum" << withLabels(series.labels) << ' '
+                << formatValue(histogram->getSum()) << '\n';
+            out << f.name << "_count" << withLabels(series.labels) << ' ' << count << '\n';
+        }
+    }
+    return out.str();
+}
+
+MetricsExporter::MetricsExporter(const MetricsRegistry* metrics)
+    : registry(metrics), listenSocket(-1), dumpInterval(0), stopping(false) {
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::writeFile() const {
+    if (dumpPath.empty()) return false;
+
+    std::string temporary = dumpPath + ".tmp";
+    {
+        std::ofstream file(temporary, std::ios::trunc);
+        if (!file.is_open()) return false;
+        file << registry->render();
+        if (!file) return false;
+    }
+    return std::rename(temporary.c_str(), dumpPath.c_str()) == 0;
+}
+
+bool MetricsExporter::startFileDump(const std::string& path, double intervalSeconds) {
+    if (dumpThread.joinable()) return false;
+
+    dumpPath = path;
+    dumpInterval = (intervalSeconds > 0) ? intervalSeconds : 5.0;
+    if (!writeFile()) {
+        dumpPath.clear();
+        return false;
+    }
+    dumpThread = std::thread(&MetricsExporter::dumpLoop, this);
+    return true;
+}
+
+void MetricsExporter::dumpLoop() {
+    auto interval = std::chrono::duration<double>(dumpInterval);
+    std::unique_lock<std::mutex> lock(stopMutex);
+    while (!stopCV.wait_for(lock, interval, [this]() { return stopping.load(); })) {
+        lock.unlock();
+        writeFile();
+        lock.lock();
+    }
+}
+
+#ifdef _WIN32
+
+bool MetricsExporter::startHttp(int) {
+    return false;
+}
+
+void MetricsExporter::serveLoop() {
+}
+
+void MetricsExporter::handleConnection(int) {
+}
+
+#else
+
+bool MetricsExporter::startHttp(int port) {
+    if (httpThread.joinable() || port <= 0 || port > 65535) return false;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return false;
+
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+    sockaddr_in address;
+    std::memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+        listen(fd, 16) != 0) {
+        close(fd);
+        return false;
+    }
+
+    listenSocket = fd;
+    httpThread = std::thread(&MetricsExporter::serveLoop, this);
+    return true;
+}
+
+void MetricsExporter::serveLoop() {
+    // Polls so stop() is noticed within a tenth of a second
+    while (!stopping) {
+        pollfd waiting = {listenSocket, POLLIN, 0};
+        if (poll(&waiting, 1, 100) <= 0) continue;
+
+        int client = accept(listenSocket, nullptr, nullptr);
+        if (client < 0) continue;
+        handleConnection(client);
+        close(client);
+    }
+}
+
+void MetricsExporter::handleConnection(int client) {
+    // A scraper sends one small request; a slow one is not waited on long
+    timeval timeout = {1, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    std::string request;
+    char buffer[1024];
+    while (request.find("\r\n\r\n") == std::string::npos && request.size() < 8192) {
+        ssize_t received = recv(client, buffer, sizeof(buffer), 0);
+        if (received <= 0) break;
+        request.append(buffer, static_cast<size_t>(received));
+    }
+
+    std::string status = "200 OK";
+    std::string body;
+    if (request.compare(0, 13, "GET /metrics ") == 0 || request.compare(0, 6, "GET / ") == 0) {
+        body = registry->render();
+    } else if (request.compare(0, 4, "GET ") == 0) {
+        status = "404 Not Found";
+        body = "Metrics are served at /metrics\n";
+    } else {
+        status = "405 Method Not Allowed";
+        body = "Only GET is supported\n";
+    }
+
+    std::string response = "HTTP/1.1 " + status + "\r\n"
+        "Content-Type: text/plain; version=0.0.4; charset=utf-8\r\n"
+        "Content-Length: " + std::to_string(body.size()) + "\r\n"
+        "Connection: close\r\n\r\n" + body;
+
+    size_t sent = 0;
+    while (sent < response.size()) {
+        ssize_t written = send(client, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+        if (written <= 0) break;
+        sent += static_cast<size_t>(written);
+    }
+}
+
+#endif
+
+void MetricsExporter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(stopMutex);
+        if (stopping) return;
+        stopping = true;
+    }
+    stopCV.notify_all();
+
+    if (httpThread.joinable()) {
+        httpThread.join();
+    }
+#ifndef _WIN32
+    if (listenSocket >= 0) {
+        close(listenSocket);
+        listenSocket = -1;
+    }
+#endif
+    if (dumpThread.joinable()) {
+        dumpThread.join();
+        writeFile();
+    }
+}
@@ -0,0 +1,189 @@
+// ============================================
+// FILE: profiled_mutex.cpp
+// DESCRIPTION: Lock contention profiles and the end-of-run report
+// ============================================
+
+#include "../include/profiled_mutex.hpp"
+
+#ifdef DATACENTER_LOCK_PROFILING
+
+#include <sstream>
+#include <iomanip>
+#include <vector>
+#include <cstring>
+#include <algorithm>
+
+static const size_t TOP_SITES = 5;
+
+LockProfile::LockProfile(const char* mutexName)
+    : name(mutexName), acquisitions(0), contentions(0), unlistedContentions(0),
+      waitTime(1e-9), holdTime(1e-9) {
+    for (Site& site : sites) {
+        site.key.store(0, std::memory_order_relaxed);
+        site.file.store(nullptr, std::memory_order_relaxed);
+        site.line.store(0, std::memory_order_relaxed);
+        site.contentions.store(0, std::memory_order_relaxed);
+        site.waitNanos.store(0, std::memory_order_relaxed);
+    }
+}
+
+struct ProfileRegistry {
+    std::mutex mutex;
+    std::vector<LockProfile*> profiles;
+};
+
+// Built on first use, since mutexes may be constructed during static
+// initialisation, and never freed, so a mutex destroyed during static
+// teardown can still record into its profile
+static ProfileRegistry& profileRegistry() {
+    static ProfileRegistry* registry = new ProfileRegistry();
+    return *registry;
+}
+
+LockProfile* LockProfile::named(const char* name) {
+    ProfileRegistry& registry = profileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    for (LockProfile* profile : registry.profiles) {
+        if (std::strcmp(profile->name, name) == 0) return profile;
+    }
+    LockProfile* profile = new LockProfile(name);
+    registry.profiles.push_back(profile);
+    return profile;
+}
+
+std::vector<const LockProfile*> LockProfile::all() {
+    ProfileRegistry& registry = profileRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return std::vector<const LockProfile*>(registry.profiles.begin(), registry.profiles.end());
+}
+
+void LockProfile::recordAcquisition(const char* file, int line, uint64_t waitNanos, bool contended) {
+    acquisitions.fetch_add(1, std::memory_order_relaxed);
+    waitTime.record(waitNanos * 1e-9);
+    if (contended) {
+        contentions.fetch_add(1, std::memory_order_relaxed);
+        recordSite(file, line, waitNanos);
+    }
+}
+
+void LockProfile::recordSite(const char* file, int line, uint64_t waitNanos) {
+    // User-space addresses fit in 48 bits, leaving room for the line and a
+    // never-zero marker bit, so distinct sites always get distinct keys
+    uint64_t key = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(file)) |
+                   (static_cast<uint64_t>(line & 0x7fff) << 48) | (uint64_t(1) << 63);
+    size_t start = static_cast<size_t>((key * 0x9E3779B97F4A7C15ULL) >> 58);
+
+    for (size_t probe = 0; probe < SITE_COUNT; probe++) {
+        Site& site = sites[(start + probe) % SITE_COUNT];
+        uint64_t seen = site.key.load(std::memory_order_acquire);
+        if (seen == 0) {
+            if (site.key.compare_exchange_strong(seen, key, std::memory_order_acq_rel)) {
+                site.file.store(file, std::memory_order_relaxed);
+                site.line.store(line, std::memory_order_relaxed);
+                seen = key;
+            }
+        }
+        if (seen == key) {
+            site.contentions.fetch_add(1, std::memory_order_relaxed);
+            site.waitNanos.fetch_add(waitNanos, std::memory_order_relaxed);
+            return;
+        }
+    }
+    unlistedContentions.fetch_add(1, std::memory_order_relaxed);
+}
+
+static std::string siteName(const char* file, int line) {
+    if (!file) return "(std lock)";
+    const char* base = file;
+    for (const char* c = file; *c; c++) {
+        if (*c == '/' || *c == '\\') base = c + 1;
+    }
+    return std::string(base) + ":" + std::to_string(line);
+}
+
+std::string LockProfile::getReport() const {
+    std::ostringstream report;
+    report << std::fixed << std::setprecision(3);
+
+    uint64_t total = acquisitions.load(std::memory_order_relaxed);
+    uint64_t contended = contentions.load(std::memory_order_relaxed);
+    report << name << "\n";
+    report << "  Acquisitions: " << total << " (" << contended << " contended, "
+           << std::setprecision(2) << (total > 0 ? 100.0 * contended / total : 0.0) << "%)\n";
+    report << std::setprecision(3);
+
+    const LatencyHistogram* histograms[2] = {&waitTime, &holdTime};
+    const char* labels[2] = {"  Wait (us):", "  Hold (us):"};
+    for (int h = 0; h < 2; h++) {
+        const LatencyHistogram& histogram = *histograms[h];
+        report << labels[h]
+               << " p50 " << histogram.getPercentile(50) * 1e6
+               << "  p99 " << histogram.getPercentile(99) * 1e6
+               << "  p99.9 " << histogram.getPercentile(99.9) * 1e6
+               << "  max " << histogram.getMax() * 1e6
+               << "  total " << histogram.getSum() * 1e3 << " ms\n";
+    }
+
+    // The table may hold one site twice if two threads claimed it at once
+    std::vector<std::pair<std::string, std::pair<uint64_t, uint64_t>>> listed;
+    for (const Site& site : sites) {
+        if (site.key.load(std::memory_order_acquire) == 0) continue;
+        std::string where = siteName(site.file.load(std::memory_order_relaxed),
+                                     site.line.load(std::memory_order_relaxed));
+        uint64_t count = site.contentions.load(std::memory_order_relaxed);
+        uint64_t nanos = site.waitNanos.load(std::memory_order_relaxed);
+        auto existing = std::find_if(listed.begin(), listed.end(),
+            [&where](const std::pair<std::string, std::pair<uint64_t, uint64_t>>& entry) {
+                return entry.first == where;
+            });
+        if (existing != listed.end()) {
+            existing->second.first += count;
+            existing->second.second += nanos;
+        } else {
+            listed.push_back({where, {count, nanos}});
+        }
+    }
+    if (listed.empty()) return report.str();
+
+    std::sort(listed.begin(), listed.end(),
+        [](const std::pair<std::string, std::pair<uint64_t, uint64_t>>& a,
+           const std::pair<std::string, std::pair<uint64_t, uint64_t>>& b) {
+            return a.second.second > b.second.second;
+        });
+
+    report << "  Top contending call sites (waits, total wait ms):\n";
+    for (size_t i = 0; i < listed.size() && i < TOP_SITES; i++) {
+        report << "    " << std::left << std::setw(32) << listed[i].first << std::right
+               << std::setw(10) << listed[i].second.first
+               << std::setw(14) << listed[i].second.second / 1e6 << "\n";
+    }
+    uint64_t unlisted = unlistedContentions.load(std::memory_order_relaxed);
+    if (unlisted > 0) {
+        report << "    (" << unlisted << " waits at further sites not tracked)\n";
+    }
+    return report.str();
+}
+
+std::string getLockContentionReport() {
+    std::vector<const LockProfile*> profiles = LockProfile::all();
+    std::stable_sort(profiles.begin(), profiles.end(),
+        [](const LockProfile* a, const LockProfile* b) {
+            return a->getTotalWaitSeconds() > b->getTotalWaitSeconds();
+        });
+
+    std::ostringstream report;
+    report << "\n========== LOCK CONTENTION ==========\n";
+    for (const LockProfile* profile : profiles) {
+        report << profile->getReport();
+    }
+    report << "=====================================\n";
+    return report.str();
+}
+
+#else
+
+std::string getLockContentionReport() {
+    return "";
+}
+
+#endif
@@ -0,0 +1,162 @@
+// ============================================
+// FILE: ready_queue.cpp
+// DESCRIPTION: Implementation of the sharded ready queues
+// ============================================
+
+#include "../include/ready_queue.hpp"
+#include <thread>
+#include <chrono>
+#include <algorithm>
+
+static const unsigned int MAX_READY_SHARDS = 64;
+
+// Each thread gets a slot the first time it touches any ready queue;
+// slots are dealt out in turn so neighbouring threads use different shards
+static std::atomic<unsigned int> nextThreadSlot(0);
+
+static unsigned int threadSlot() {
+    thread_local unsigned int slot = nextThreadSlot.fetch_add(1);
+    return slot;
+}
+
+ShardedReadyQueue::ShardedReadyQueue(unsigned int shardCount) : headsByPriority(false) {
+    if (shardCount == 0) {
+        shardCount = std::max(1u, std::thread::hardware_concurrency());
+    }
+    shardCount = std::min(shardCount, MAX_READY_SHARDS);
+
+    shards.reserve(shardCount);
+    for (unsigned int i = 0; i < shardCount; i++) {
+        Shard* shard = new Shard();
+        for (int p = 0; p < PRIORITY_CLASSES; p++) {
+            shard->sizes[p] = 0;
+        }
+        shard->nextSequence = 0;
+        shards.push_back(shard);
+    }
+    for (int p = 0; p < PRIORITY_CLASSES; p++) {
+        queued[p] = 0;
+    }
+    runs.resize(shards.size() * PRIORITY_CLASSES);
+}
+
+ShardedReadyQueue::~ShardedReadyQueue() {
+    for (Shard* shard : shards) {
+        delete shard;
+    }
+}
+
+ShardedReadyQueue::Shard* ShardedReadyQueue::homeShard() {
+    return shards[threadSlot() % shards.size()];
+}
+
+int ShardedReadyQueue::bucketFor(const Job* job) {
+    return static_cast<int>(job->getPriority()) - 1;
+}
+
+void ShardedReadyQueue::push(Job* job, bool retain) {
+    int p = bucketFor(job);
+    Shard* shard = homeShard();
+    {
+        // Stamped under the shard lock so every bucket stays in stamp order
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        Entry entry;
+        entry.stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+        entry.sequence = shard->nextSequence++;
+        entry.job = job;
+        shard->buckets[p].push_back(entry);
+        if (retain) {
+            shard->retained.push_back(job);
+        }
+        shard->sizes[p].fetch_add(1, std::memory_order_release);
+    }
+
+    // Counted only once the job can be found, so a non-zero count always
+    // means the consumer will find one
+    queued[p].fetch_add(1, std::memory_order_release);
+}
+
+// std heap order: true when a is served after b
+bool ShardedReadyQueue::servedAfter(const RunHead& a, const RunHead& b, bool byPriority) {
+    if (byPriority && a.bucket != b.bucket) return a.bucket > b.bucket;
+    if (a.stamp != b.stamp) return a.stamp > b.stamp;
+    if (a.shard != b.shard) return a.shard > b.shard;
+    return a.sequence > b.sequence;
+}
+
+void ShardedReadyQueue::refill(bool byPriority) {
+    // Shards with nothing queued are skipped without locking; the others
+    // hand over all their buckets at once, swapped into the runs
+    for (size_t s = 0; s < shards.size(); s++) {
+        Shard* shard = shards[s];
+        bool any = false;
+        for (int p = 0; p < PRIORITY_CLASSES && !any; p++) {
+            any = shard->sizes[p].load(std::memory_order_acquire) > 0;
+        }
+        if (!any) continue;
+
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        for (int p = 0; p < PRIORITY_CLASSES; p++) {
+            size_t taken = shard->buckets[p].size();
+            if (taken == 0) continue;
+            size_t run = s * PRIORITY_CLASSES + p;
+            runs[run].swap(shard->buckets[p]);
+            shard->sizes[p].fetch_sub(taken, std::memory_order_relaxed);
+
+            const Entry& front = runs[run].front();
+            heads.push_back({p, front.stamp, static_cast<unsigned int>(s), front.sequence, run});
+        }
+    }
+
+    headsByPriority = byPriority;
+    std::make_heap(heads.begin(), heads.end(),
+        [byPriority](const RunHead& a, const RunHead& b) { return servedAfter(a, b, byPriority); });
+}
+
+Job* ShardedReadyQueue::pop(bool byPriority) {
+    if (heads.empty()) {
+        refill(byPriority);
+        if (heads.empty()) return nullptr;
+    }
+
+    auto later = [byPriority](const RunHead& a, const RunHead& b) {
+        return servedAfter(a, b, byPriority);
+    };
+    if (headsByPriority != byPriority) {
+        std::make_heap(heads.begin(), heads.end(), later);
+        headsByPriority = byPriority;
+    }
+
+    std::pop_heap(heads.begin(), heads.end(), later);
+    RunHead& head = heads.back();
+    int p = head.bucket;
+    std::deque<Entry>& run = runs[head.run];
+    Job* job = run.front().job;
+    run.pop_front();
+    if (run.empty()) {
+        heads.pop_back();
+    } else {
+        head.stamp = run.front().stamp;
+        head.sequence = run.front().sequence;
+        std::push_heap(heads.begin(), heads.end(), later);
+    }
+
+    queued[p].fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+size_t ShardedReadyQueue::size() const {
+    size_t total = 0;
+    for (int p = 0; p < PRIORITY_CLASSES; p++) {
+        total += queued[p].load(std::memory_order_acquire);
+    }
+    return total;
+}
+
+void ShardedReadyQueue::takeRetained(std::vector<Job*>& out) {
+    for (Shard* shard : shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        out.insert(out.end(), shard->retained.begin(), shard->retained.end());
+        shard->retained.clear();
+    }
+}
@@ -5,106 +5,373 @@
 
 #include "../include/resource_manager.hpp"
 #include "../include/logger.hpp"
+#include "../include/metrics.hpp"
 #include <algorithm>
 
-ResourceManager::ResourceManager(int cpu, int ram, int disk, int network)
-    : totalCPU(cpu), totalRAM(ram), totalDisk(disk), totalNetwork(network),
-      availableCPU(cpu), availableRAM(ram), availableDisk(disk), availableNetwork(network) {
+// Lock-free mode packs the available vector as 16-bit fields
+static const int PACKED_FIELD_BITS = 16;
+static const uint64_t PACKED_FIELD_MAX = 0xFFFF;
+
+static_assert(ResourceRequest::DIMENSIONS * PACKED_FIELD_BITS <= 64,
+              "Packed available vector must fit in one 64-bit word");
+
+static uint64_t packResources(const ResourceRequest& r) {
+    uint64_t packed = 0;
+    for (size_t i = 0; i < ResourceRequest::DIMENSIONS; i++) {
+        packed |= static_cast<uint64_t>(r[i]) << (i * PACKED_FIELD_BITS);
+    }
+    return packed;
+}
+
+static ResourceRequest unpackResources(uint64_t packed) {
+    ResourceRequest r;
+    for (size_t i = 0; i < ResourceRequest::DIMENSIONS; i++) {
+        r[i] = static_cast<int>((packed >> (i * PACKED_FIELD_BITS)) & PACKED_FIELD_MAX);
+    }
+    return r;
+}
+
+ResourceManager::ResourceManager(int cpu, int ram, int disk, int network, bool lockFreeMode)
+    : total(cpu, ram, disk, network), available(cpu, ram, disk, network),
+      lockFree(lockFreeMode), packedAvailable(0),
+      resourceMutex("ResourceManager::resourceMutex"), releaseEpoch(0),
+      simulatedClock(nullptr), clockFrozen(false), frozenTime(0),
+      clockOrigin(std::chrono::steady_clock::now()), accountingStart(0), lastChange(0),
+      heldSeconds{} {
     
-    globalLogger->logEvent("ResourceManager initialized: CPU=" +
+    if (lockFree) {
+        ResourceRequest packedLimit;
+        for (size_t i = 0; i < ResourceRequest::DIMENSIONS; i++) {
+            packedLimit[i] = static_cast<int>(PACKED_FIELD_MAX);
+        }
+        if (!total.fits(packedLimit) || total.anyNegative()) {
+            currentLogger()->logEvent("ResourceManager: totals exceed 16 bits, lock-free mode disabled");
+            lockFree = false;
+        } else {
+            packedAvailable.store(packResources(total));
+        }
+    }
+    
+    currentLogger()->logEvent("ResourceManager initialized: CPU=" +
         std::to_string(cpu) + " cores, RAM=" + std::to_string(ram) + 
         "GB, Disk=" + std::to_string(disk) + " slots, Network=" + 
-        std::to_string(network) + " slots");
+        std::to_string(network) + " slots" + (lockFree ? " (lock-free)" : ""));
+}
+
+ResourceRequest ResourceManager::loadAvailable() const {
+    if (lockFree) {
+        return unpackResources(packedAvailable.load(std::memory_order_acquire));
+    }
+    return available;
+}
+
+void ResourceManager::storeAvailable(const ResourceRequest& free) {
+    if (lockFree) {
+        packedAvailable.store(packResources(free), std::memory_order_release);
+    } else {
+        available = free;
+    }
+}
+
+bool ResourceManager::fitsAvailable(const ResourceRequest& req) const {
+    return req.fits(loadAvailable());
 }
 
 bool ResourceManager::canAllocate(const ResourceRequest& req) {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    
-    return (req.cpuCores <= availableCPU &&
-            req.ramGB <= availableRAM &&
-            req.diskSlots <= availableDisk &&
-            req.networkSlots <= availableNetwork);
+    if (lockFree) {
+        return fitsAvailable(req);
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return fitsAvailable(req);
 }
 
 bool ResourceManager::allocateResources(int jobId, const ResourceRequest& req) {
-    std::lock_guard<std::mutex> lock(resourceMutex);
+    // The counters and the allocation table change together under the
+    // lock in both modes; lock-free mode only spares the readers
+    ProfiledLockGuard lock(resourceMutex);
     
     // Check if resources are available
-    if (req.cpuCores > availableCPU || req.ramGB > availableRAM ||
-        req.diskSlots > availableDisk || req.networkSlots > availableNetwork) {
+    ResourceRequest free = loadAvailable();
+    if (!req.fits(free)) {
         return false;
     }
     
     // Allocate resources
-    availableCPU -= req.cpuCores;
-    availableRAM -= req.ramGB;
-    availableDisk -= req.diskSlots;
-    availableNetwork -= req.networkSlots;
+    storeAvailable(free - req);
+    recordAllocation(jobId, req);
+    return true;
+}
+
+bool ResourceManager::allocateBatch(const std::vector<Allocation>& batch) {
+    ResourceRequest sum;
+    for (const Allocation& entry : batch) {
+        sum += entry.allocated;
+    }
     
-    // Record allocation
-    allocations.push_back({jobId, req});
+    ProfiledLockGuard lock(resourceMutex);
     
-    globalLogger->logJobEvent(jobId, 
-        "Resources allocated - CPU:" + std::to_string(req.cpuCores) + 
-        " RAM:" + std::to_string(req.ramGB) + "GB" +
-        " Disk:" + std::to_string(req.diskSlots) +
-        " Network:" + std::to_string(req.networkSlots));
+    ResourceRequest free = loadAvailable();
+    if (!sum.fits(free)) {
+        return false;
+    }
+    storeAvailable(free - sum);
     
+    for (const Allocation& entry : batch) {
+        recordAllocation(entry.jobId, entry.allocated);
+    }
     return true;
 }
 
+void ResourceManager::recordAllocation(int jobId, const ResourceRequest& req) {
+    // Record allocation - a job allocating again grows its existing slot
+    auto slot = allocationSlots.find(jobId);
+    if (slot != allocationSlots.end()) {
+        allocations[slot->second].allocated += req;
+    } else {
+        allocationSlots.emplace(jobId, allocations.size());
+        allocations.push_back({jobId, req});
+    }
+    
+    advanceAccounting(clockNow());
+    allocated += req;
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        peakAllocated[r] = std::max(peakAllocated[r], allocated[r]);
+    }
+    
+    currentLogger()->traceEvent(TraceEventType::RESOURCES_ALLOCATED, jobId,
+        req.cpuCores, req.ramGB, req.diskSlots, req.networkSlots);
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(jobId, 
+            "Resources allocated - CPU:" + std::to_string(req.cpuCores) + 
+            " RAM:" + std::to_string(req.ramGB) + "GB" +
+            " Disk:" + std::to_string(req.diskSlots) +
+            " Network:" + std::to_string(req.networkSlots));
+    }
+}
+
 void ResourceManager::releaseResources(int jobId) {
-    std::lock_guard<std::mutex> lock(resourceMutex);
+    ProfiledLockGuard lock(resourceMutex);
     
     // Find and release the allocation
-    auto it = std::find_if(allocations.begin(), allocations.end(),
-        [jobId](const Allocation& a) { return a.jobId == jobId; });
-    
-    if (it != allocations.end()) {
-        availableCPU += it->allocated.cpuCores;
-        availableRAM += it->allocated.ramGB;
-        availableDisk += it->allocated.diskSlots;
-        availableNetwork += it->allocated.networkSlots;
+    auto slot = allocationSlots.find(jobId);
+    
+    if (slot != allocationSlots.end()) {
+        size_t index = slot->second;
+        const ResourceRequest& held = allocations[index].allocated;
+        storeAvailable(loadAvailable() + held);
         
-        globalLogger->logJobEvent(jobId, "Resources released");
+        advanceAccounting(clockNow());
+        allocated -= held;
         
-        allocations.erase(it);
+        currentLogger()->traceEvent(TraceEventType::RESOURCES_RELEASED, jobId,
+            held.cpuCores, held.ramGB, held.diskSlots, held.networkSlots);
+        currentLogger()->logJobEvent(jobId, "Resources released");
         
-        // Notify waiting threads
-        resourceCV.notify_all();
+        // Swap-remove: the last slot moves into the freed one
+        if (index + 1 != allocations.size()) {
+            allocations[index] = allocations.back();
+            allocationSlots[allocations[index].jobId] = index;
+        }
+        allocations.pop_back();
+        allocationSlots.erase(slot);
+        releaseEpoch++;
+        
+        // Wake only the waiters this release can actually satisfy
+        for (Waiter* waiter : waiters) {
+            if (!waiter->satisfiable && fitsAvailable(*waiter->request)) {
+                waiter->satisfiable = true;
+                waiter->cv.notify_one();
+            }
+        }
+    }
+}
+
+unsigned long ResourceManager::getReleaseEpoch() {
+    ProfiledLockGuard lock(resourceMutex);
+    return releaseEpoch;
+}
+
+bool ResourceManager::waitForRelease(const ResourceRequest& req, unsigned long seenEpoch,
+                                     std::chrono::steady_clock::time_point deadline) {
+    ProfiledUniqueLock lock(resourceMutex);
+    
+    // A release already happened since the caller's last attempt
+    if (releaseEpoch != seenEpoch && fitsAvailable(req)) {
+        return true;
     }
+    
+    Waiter waiter;
+    waiter.request = &req;
+    waiter.satisfiable = false;
+    waiters.push_back(&waiter);
+    
+    waiter.cv.wait_until(lock, deadline, [&waiter]() { return waiter.satisfiable; });
+    
+    waiters.erase(std::find(waiters.begin(), waiters.end(), &waiter));
+    return waiter.satisfiable;
 }
 
 ResourceRequest ResourceManager::getAvailableResources() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    return ResourceRequest(availableCPU, availableRAM, availableDisk, availableNetwork);
+    if (lockFree) {
+        return loadAvailable();
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return loadAvailable();
 }
 
 ResourceRequest ResourceManager::getTotalResources() {
-    return ResourceRequest(totalCPU, totalRAM, totalDisk, totalNetwork);
+    return total;
 }
 
 double ResourceManager::getCPUUtilization() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    return 100.0 * (totalCPU - availableCPU) / totalCPU;
+    if (lockFree) {
+        return 100.0 * (total.cpuCores - loadAvailable().cpuCores) / total.cpuCores;
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return 100.0 * (total.cpuCores - available.cpuCores) / total.cpuCores;
 }
 
 double ResourceManager::getRAMUtilization() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    return 100.0 * (totalRAM - availableRAM) / totalRAM;
+    if (lockFree) {
+        return 100.0 * (total.ramGB - loadAvailable().ramGB) / total.ramGB;
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return 100.0 * (total.ramGB - available.ramGB) / total.ramGB;
 }
 
 double ResourceManager::getDiskUtilization() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    return 100.0 * (totalDisk - availableDisk) / totalDisk;
+    if (lockFree) {
+        return 100.0 * (total.diskSlots - loadAvailable().diskSlots) / total.diskSlots;
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return 100.0 * (total.diskSlots - available.diskSlots) / total.diskSlots;
 }
 
 double ResourceManager::getNetworkUtilization() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
-    return 100.0 * (totalNetwork - availableNetwork) / totalNetwork;
+    if (lockFree) {
+        return 100.0 * (total.networkSlots - loadAvailable().networkSlots) / total.networkSlots;
+    }
+    ProfiledLockGuard lock(resourceMutex);
+    return 100.0 * (total.networkSlots - available.networkSlots) / total.networkSlots;
+}
+
+double ResourceManager::clockNow() const {
+    if (simulatedClock) return simulatedClock->load(std::memory_order_relaxed);
+    if (clockFrozen) return frozenTime;
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - clockOrigin).count();
+}
+
+void ResourceManager::advanceAccounting(double now) {
+    double elapsed = now - lastChange;
+    if (elapsed > 0) {
+        for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+            heldSeconds[r] += allocated[r] * elapsed;
+        }
+    }
+    lastChange = std::max(lastChange, now);
+}
+
+void ResourceManager::restartAccounting() {
+    accountingStart = clockNow();
+    lastChange = accountingStart;
+    peakAllocated = allocated;
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        heldSeconds[r] = 0;
+    }
+}
+
+void ResourceManager::resetUtilization() {
+    ProfiledLockGuard lock(resourceMutex);
+    restartAccounting();
+}
+
+void ResourceManager::setSimulatedClock(const std::atomic<double>* clock) {
+    ProfiledLockGuard lock(resourceMutex);
+    if (clock) {
+        simulatedClock = clock;
+        clockFrozen = false;
+        restartAccounting();
+    } else if (simulatedClock) {
+        frozenTime = simulatedClock->load(std::memory_order_relaxed);
+        clockFrozen = true;
+        simulatedClock = nullptr;
+    }
+}
+
+UtilizationSample ResourceManager::getUtilizationSample() {
+    ProfiledLockGuard lock(resourceMutex);
+    
+    // Held since the last change is added without moving lastChange
+    UtilizationSample sample;
+    sample.time = clockNow();
+    double elapsed = std::max(0.0, sample.time - lastChange);
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        sample.heldSeconds[r] = heldSeconds[r] + allocated[r] * elapsed;
+    }
+    return sample;
+}
+
+double ResourceManager::getWindowUtilization(const UtilizationSample& from, const UtilizationSample& to,
+                                             size_t resource) const {
+    double span = to.time - from.time;
+    if (span <= 0 || total[resource] <= 0) return 0.0;
+    return 100.0 * (to.heldSeconds[resource] - from.heldSeconds[resource]) / (total[resource] * span);
+}
+
+double ResourceManager::getAverageUtilization(size_t resource) {
+    UtilizationSample start = {0, {0, 0, 0, 0}};
+    {
+        ProfiledLockGuard lock(resourceMutex);
+        start.time = accountingStart;
+    }
+    UtilizationSample now = getUtilizationSample();
+    return getWindowUtilization(start, now, resource);
+}
+
+double ResourceManager::getPeakUtilization(size_t resource) {
+    ProfiledLockGuard lock(resourceMutex);
+    if (total[resource] <= 0) return 0.0;
+    return 100.0 * peakAllocated[resource] / total[resource];
+}
+
+void ResourceManager::registerMetrics(MetricsRegistry& registry, const std::string& labels) {
+    static const char* names[4] = {"cpu", "ram", "disk", "network"};
+    std::string prefix = labels.empty() ? "" : labels + ",";
+    
+    for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+        std::string series = prefix + "resource=\"" + names[r] + "\"";
+        registry.addGaugeFunction("datacenter_resource_capacity",
+            "Total units of the resource in the pool", series,
+            [this, r]() { return static_cast<double>(total[r]); });
+        registry.addGaugeFunction("datacenter_resource_available",
+            "Units of the resource not allocated to any job", series,
+            [this, r]() { return static_cast<double>(getAvailableResources()[r]); });
+        registry.addGaugeFunction("datacenter_resource_utilization_average_percent",
+            "Time-weighted utilization since accounting started", series,
+            [this, r]() { return getAverageUtilization(r); });
+        registry.addGaugeFunction("datacenter_resource_utilization_peak_percent",
+            "Highest utilization since accounting started", series,
+            [this, r]() { return getPeakUtilization(r); });
+    }
+    registry.addGaugeFunction("datacenter_resource_holders",
+        "Jobs currently holding resources in the pool", labels,
+        [this]() { return static_cast<double>(getAllocationCount()); });
 }
 
 std::vector<ResourceManager::Allocation> ResourceManager::getAllocations() {
-    std::lock_guard<std::mutex> lock(resourceMutex);
+    ProfiledLockGuard lock(resourceMutex);
     return allocations;
-}
\ No newline at end of file
+}
+
+bool ResourceManager::getAllocation(int jobId, ResourceRequest& allocated) {
+    ProfiledLockGuard lock(resourceMutex);
+    auto slot = allocationSlots.find(jobId);
+    if (slot == allocationSlots.end()) return false;
+    allocated = allocations[slot->second].allocated;
+    return true;
+}
+
+size_t ResourceManager::getAllocationCount() {
+    ProfiledLockGuard lock(resourceMutex);
+    return allocations.size();
+}
@@ -5,111 +5,557 @@
 
 #include "../include/scheduler.hpp"
 #include "../include/logger.hpp"
+#include "../include/metrics.hpp"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <limits>
+
+static const int MAX_EXECUTOR_WORKERS = 1024;
 
 Scheduler::Scheduler(ResourceManager* rm, DeadlockManager* dm)
-    : resourceManager(rm), deadlockManager(dm),
+    : policy(new PriorityPolicy()), schedulerMutex("Scheduler::schedulerMutex"),
+      resourceManager(rm), deadlockManager(dm), cluster(nullptr),
+      online(false), acceptingArrivals(false), dispatcherIdle(false),
+      retainCompletedJobs(true),
+      backfillDepth(0), backfilledJobs(0), reservationValid(false), lastBackfilled(nullptr),
+      startClock(std::chrono::steady_clock::now()),
+      totalJobs(0), completedJobs(0), totalWaitingTime(0), totalExecutionTime(0) {
+    
+    currentLogger()->logEvent("Scheduler initialized with Priority Scheduling");
+}
+
+Scheduler::Scheduler(Cluster* nodes)
+    : policy(new PriorityPolicy()), schedulerMutex("Scheduler::schedulerMutex"),
+      resourceManager(nullptr), deadlockManager(nullptr), cluster(nodes),
+      online(false), acceptingArrivals(false), dispatcherIdle(false),
+      retainCompletedJobs(true),
+      backfillDepth(0), backfilledJobs(0), reservationValid(false), lastBackfilled(nullptr),
+      startClock(std::chrono::steady_clock::now()),
       totalJobs(0), completedJobs(0), totalWaitingTime(0), totalExecutionTime(0) {
     
-    globalLogger->logEvent("Scheduler initialized with Priority Scheduling");
+    currentLogger()->logEvent("Scheduler initialized with Priority Scheduling across " +
+        std::to_string(nodes->getNodeCount()) + " nodes");
 }
 
 Scheduler::~Scheduler() {
+    if (dispatcherThread.joinable()) {
+        dispatcherThread.join();
+    }
+    
+    // Workers finish their current jobs before the jobs are deleted
+    executor.reset();
+    
     // Clean up all jobs
+    std::vector<Job*> allJobs;
+    submitted.takeRetained(allJobs);
     for (Job* job : allJobs) {
         delete job;
     }
 }
 
+void Scheduler::setSchedulingPolicy(SchedulingAlgorithm algorithm) {
+    ProfiledLockGuard lock(schedulerMutex);
+    
+    drainSubmitted();
+    std::unique_ptr<SchedulingPolicy> next(createSchedulingPolicy(algorithm));
+    while (Job* job = policy->pop()) {
+        next->push(job);
+    }
+    policy = std::move(next);
+    
+    currentLogger()->logEvent(std::string("Scheduling policy: ") + policy->getName());
+}
+
+const char* Scheduler::getSchedulingPolicyName() const {
+    ProfiledLockGuard lock(schedulerMutex);
+    return policy->getName();
+}
+
 void Scheduler::addJob(Job* job) {
-    std::lock_guard<std::mutex> lock(schedulerMutex);
+    currentLogger()->traceEvent(TraceEventType::JOB_QUEUED, job->getId());
+    if (currentLogger()->isEnabled()) {
+        std::string msg = "Added to scheduler ready queue (Priority: ";
+        msg += job->getPriorityString();
+        msg += ")";
+        currentLogger()->logJobEvent(job->getId(), msg);
+    }
     
-    readyQueue.push(job);
-    allJobs.push_back(job);
     totalJobs++;
+    submitted.push(job, retainCompletedJobs);
     
-    std::string msg = "Added to scheduler ready queue (Priority: ";
-    msg += job->getPriorityString();
-    msg += ")";
-    globalLogger->logJobEvent(job->getId(), msg);
+    // Wake an online dispatcher waiting for work. The lock is only taken
+    // when it is idle, so busy periods add no shared lock.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (dispatcherIdle) {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        arrivalCV.notify_one();
+    }
+}
+
+void Scheduler::drainSubmitted() {
+    while (Job* job = submitted.pop(policy->ordersByPriority())) {
+        policy->push(job);
+    }
 }
 
 void Scheduler::scheduleAll() {
-    globalLogger->logEvent("Starting job scheduling...");
-    
-    // Start all jobs based on priority order
-    std::vector<Job*> jobsToStart;
-    
+    currentLogger()->logEvent("Starting job scheduling...");
+    online = false;
+    startDispatcher();
+}
+
+void Scheduler::startOnline() {
+    currentLogger()->logEvent("Starting online scheduling - dispatcher waits for arrivals");
     {
-        std::lock_guard<std::mutex> lock(schedulerMutex);
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        online = true;
+        acceptingArrivals = true;
+    }
+    startDispatcher();
+}
+
+void Scheduler::closeArrivals() {
+    {
+        std::lock_guard<std::mutex> lock(arrivalMutex);
+        acceptingArrivals = false;
+    }
+    arrivalCV.notify_all();
+}
+
+void Scheduler::startDispatcher() {
+    if (!executor) {
+        // Every admitted job holds at least one core and sleeps through its
+        // phases, so the pool must be at least as wide as the CPU capacity
+        // for admitted jobs never to queue behind each other.
+        // A large cluster is capped; admitted jobs beyond the cap queue in
+        // the executor.
+        int totalCores = cluster ? cluster->getTotalResources().cpuCores
+                                 : resourceManager->getTotalResources().cpuCores;
+        unsigned int workers = std::max(std::thread::hardware_concurrency(),
+            static_cast<unsigned int>(std::min(totalCores, MAX_EXECUTOR_WORKERS)));
+        executor.reset(new JobExecutor(workers));
+    }
+    
+    if (dispatcherThread.joinable()) {
+        dispatcherThread.join();
+    }
+    dispatcherThread = std::thread(&Scheduler::dispatchJobs, this);
+}
+
+void Scheduler::dispatchJobs() {
+    // Admit jobs in priority order; only admitted (runnable) jobs are
+    // handed to the executor, so workers never sit in a retry loop
+    while (true) {
+        Job* job = popNextJob();
+        if (job == nullptr) {
+            if (waitForArrival()) continue;
+            break;
+        }
         
-        while (!readyQueue.empty()) {
-            Job* job = readyQueue.top();
-            readyQueue.pop();
-            jobsToStart.push_back(job);
+        if (!admitJob(job)) {
+            continue;   // The policy took it back; try the new head
+        }
+        
+        submitJob(job);
+        if (!cluster) {
+            admitBurst();
+        }
+        
+        // Small delay to simulate arrival time differences; online
+        // arrivals are paced by whoever adds them
+        if (!online) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }
     
-    // Start jobs (they will wait for resources internally)
-    for (Job* job : jobsToStart) {
-        job->start();
-        
+    currentLogger()->logEvent("All jobs scheduled - waiting for completion...");
+}
+
+bool Scheduler::waitForArrival() {
+    if (!online) return false;
+    
+    std::unique_lock<std::mutex> lock(arrivalMutex);
+    dispatcherIdle = true;
+    arrivalCV.wait(lock, [this]() {
+        // Pairs with the fence in addJob: either the submitter sees the
+        // dispatcher idle, or the dispatcher sees the new job
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        return !submitted.empty() || !acceptingArrivals;
+    });
+    dispatcherIdle = false;
+    
+    return !submitted.empty();
+}
+
+void Scheduler::submitJob(Job* job) {
+    currentLogger()->traceEvent(TraceEventType::JOB_DISPATCHED, job->getId());
+    if (currentLogger()->isEnabled()) {
         std::string msg = "Scheduled for execution (Priority: ";
         msg += job->getPriorityString();
         msg += ")";
-        globalLogger->logJobEvent(job->getId(), msg);
+        currentLogger()->logJobEvent(job->getId(), msg);
+    }
+    
+    recordStart(job, elapsedSeconds());
+    executor->submit([this, job]() {
+        job->run();
+        recordCompletion(job);
+    });
+}
+
+void Scheduler::admitBurst() {
+    // Everything behind the head that fits right now is admitted under one
+    // acquisition of the admission lock; jobs are submitted only after the
+    // batch has allocated them. schedulerMutex is taken first, the same
+    // order as backfillJob -> requestResources.
+    std::vector<Job*> admitted;
+    {
+        ProfiledLockGuard lock(schedulerMutex);
+        drainSubmitted();
+        DeadlockManager::AdmissionBatch batch(deadlockManager);
+        while (Job* next = policy->peek()) {
+            // The job that ends the burst is popped and admitted normally
+            // next, which counts its refusal if it is still refused then
+            if (!batch.request(next->getId(), next->getResourceNeeds(), false)) break;
+            policy->pop();
+            admitted.push_back(next);
+        }
+    }
+    
+    for (Job* job : admitted) {
+        job->recordAdmitted();
+        submitJob(job);
+    }
+}
+
+bool Scheduler::admitJob(Job* job) {
+    // A cluster job waits on one node at a time, but only briefly: a
+    // release elsewhere may free a better node, so it is re-placed often.
+    // Backfill also wants short rounds, to fill in while the head waits.
+    const auto round = (cluster || backfillDepth > 0) ? std::chrono::milliseconds(250)
+                                                      : std::chrono::milliseconds(5000);
+    const auto patience = std::chrono::milliseconds(5000);
+    auto waited = std::chrono::milliseconds(0);
+    
+    while (true) {
+        int nodeId = cluster ? cluster->placeJob(job) : -1;
+        if (job->acquireResources(round)) {
+            if (cluster) cluster->recordAdmission(nodeId);
+            return true;
+        }
+        
+        while (Job* filler = backfillJob(job, elapsedSeconds())) {
+            filler->recordAdmitted();
+            submitJob(filler);
+        }
+        
+        waited += round;
+        if (waited < patience) continue;
+        waited = std::chrono::milliseconds(0);
         
-        // Small delay to simulate arrival time differences
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        currentLogger()->logJobEvent(job->getId(), "Still waiting for resources...");
+        
+        ProfiledLockGuard lock(schedulerMutex);
+        if (policy->hasRefusalFeedback()) {
+            policy->requeueRefused(job);
+            return false;
+        }
+    }
+}
+
+Job* Scheduler::peekNextJob() {
+    ProfiledLockGuard lock(schedulerMutex);
+    drainSubmitted();
+    return policy->peek();
+}
+
+Job* Scheduler::popNextJob() {
+    ProfiledLockGuard lock(schedulerMutex);
+    drainSubmitted();
+    return policy->pop();
+}
+
+bool Scheduler::requeueRefusedHead() {
+    ProfiledLockGuard lock(schedulerMutex);
+    if (!policy->hasRefusalFeedback()) return false;
+    
+    Job* head = policy->pop();
+    if (head == nullptr) return false;
+    policy->requeueRefused(head);
+    return true;
+}
+
+void Scheduler::setBackfill(bool enabled, size_t depth) {
+    ProfiledLockGuard lock(schedulerMutex);
+    backfillDepth = enabled ? std::max<size_t>(depth, 1) : 0;
+    reservationValid = false;
+    
+    if (enabled) {
+        currentLogger()->logEvent("EASY backfill enabled (depth " + std::to_string(backfillDepth) + ")");
+    }
+}
+
+unsigned long Scheduler::getBackfilledJobs() const {
+    ProfiledLockGuard lock(schedulerMutex);
+    return backfilledJobs;
+}
+
+double Scheduler::elapsedSeconds() const {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - startClock).count();
+}
+
+void Scheduler::recordStart(Job* job, double now) {
+    if (backfillDepth == 0) return;
+    ProfiledLockGuard lock(schedulerMutex);
+    
+    double expectedEnd = now + job->getEstimatedRuntimeMs() / 1000.0;
+    runningSlots[job->getId()] = runningByEnd.emplace(expectedEnd, job);
+    
+    // A backfilled job was already charged to the reservation
+    if (job != lastBackfilled) {
+        reservationValid = false;
+    }
+    lastBackfilled = nullptr;
+}
+
+void Scheduler::computeReservation(Job* head, double now) {
+    ResourceRequest needs = head->getResourceNeeds();
+    int pools = cluster ? cluster->getNodeCount() : 1;
+    
+    reservation.head = head;
+    reservationValid = true;
+    refusedCandidates.clear();
+    
+    // Free capacity now; the head may fit already and still have been
+    // refused by the Banker's check
+    projectedPools.resize(pools);
+    for (int p = 0; p < pools; p++) {
+        ResourceManager* rm = cluster ? cluster->getNode(p)->resourceManager : resourceManager;
+        projectedPools[p] = rm->getAvailableResources();
+        if (needs.fits(projectedPools[p])) {
+            reservation.shadowTime = now;
+            reservation.pool = p;
+            reservation.extra = projectedPools[p] - needs;
+            return;
+        }
+    }
+    
+    // Replay the expected completions until some pool fits the head
+    for (const auto& entry : runningByEnd) {
+        Job* running = entry.second;
+        int p = cluster ? running->getNodeId() : 0;
+        projectedPools[p] += running->getResourceNeeds();
+        if (needs.fits(projectedPools[p])) {
+            reservation.shadowTime = std::max(entry.first, now);
+            reservation.pool = p;
+            reservation.extra = projectedPools[p] - needs;
+            return;
+        }
+    }
+    
+    // The head is larger than any pool; there is nothing to protect
+    reservation.shadowTime = std::numeric_limits<double>::infinity();
+    reservation.pool = -1;
+    reservation.extra = ResourceRequest();
+}
+
+bool Scheduler::admitBackfill(Job* job, double now) {
+    ResourceRequest needs = job->getResourceNeeds();
+    double expectedEnd = now + job->getEstimatedRuntimeMs() / 1000.0;
+    
+    // Finished before the head can start: any free capacity will do
+    if (expectedEnd <= reservation.shadowTime) {
+        if (cluster) return cluster->admit(job) >= 0;
+        return resourceManager->canAllocate(needs) &&
+               deadlockManager->requestResources(job->getId(), needs);
+    }
+    
+    // Still running at the shadow time: other nodes are free to use, but
+    // in the reserved pool only what the head leaves over
+    if (cluster && cluster->admit(job, reservation.pool) >= 0) return true;
+    if (!needs.fits(reservation.extra)) return false;
+    
+    bool admitted = cluster
+        ? cluster->admitOn(job, reservation.pool)
+        : resourceManager->canAllocate(needs) && deadlockManager->requestResources(job->getId(), needs);
+    if (admitted) {
+        reservation.extra -= needs;
     }
+    return admitted;
+}
+
+Job* Scheduler::backfillJob(Job* head, double now) {
+    ProfiledLockGuard lock(schedulerMutex);
+    if (backfillDepth == 0) return nullptr;
+    
+    if (!reservationValid || reservation.head != head) {
+        computeReservation(head, now);
+    }
+    drainSubmitted();
+    
+    Job* job = policy->removeFirstAccepted(backfillDepth, [this, head, now](Job* candidate) {
+        if (candidate == head || refusedCandidates.count(candidate)) return false;
+        if (admitBackfill(candidate, now)) return true;
+        refusedCandidates.insert(candidate);
+        return false;
+    });
+    if (job == nullptr) return nullptr;
+    
+    backfilledJobs++;
+    lastBackfilled = job;
+    
+    if (currentLogger()->isEnabled()) {
+        currentLogger()->logJobEvent(job->getId(), "Backfilled ahead of job " +
+            std::to_string(head->getId()) + " (Priority: " + job->getPriorityString() + ")");
+    }
+    return job;
+}
+
+void Scheduler::recordCompletion(Job* job) {
+    // Histograms take concurrent records, so only the sums need the lock
+    int p = static_cast<int>(job->getPriority()) - 1;
+    double waiting = job->getWaitingTime();
+    double execution = job->getExecutionTime();
+    latency[static_cast<int>(LatencyMetric::WAIT)][p].record(waiting);
+    latency[static_cast<int>(LatencyMetric::EXECUTION)][p].record(execution);
+    latency[static_cast<int>(LatencyMetric::TURNAROUND)][p].record(waiting + execution);
+    
+    ProfiledLockGuard lock(schedulerMutex);
+    
+    // Early or late, a completion changes the head's earliest start
+    auto slot = runningSlots.find(job->getId());
+    if (slot != runningSlots.end()) {
+        runningByEnd.erase(slot->second);
+        runningSlots.erase(slot);
+        reservationValid = false;
+    }
+    
+    // Collect statistics
+    totalWaitingTime += waiting;
+    totalExecutionTime += execution;
+    completedJobs++;
     
-    globalLogger->logEvent("All jobs scheduled - waiting for completion...");
+    if (!retainCompletedJobs) {
+        delete job;
+    }
 }
 
 void Scheduler::waitForAllJobs() {
-    globalLogger->logEvent("Waiting for all jobs to complete...");
+    currentLogger()->logEvent("Waiting for all jobs to complete...");
     
-    // Wait for all job threads to complete
-    for (Job* job : allJobs) {
-        job->join();
-        
-        // Collect statistics
-        totalWaitingTime += job->getWaitingTime();
-        totalExecutionTime += job->getExecutionTime();
-        completedJobs++;
+    // Every job has been handed to the executor once the dispatcher exits
+    if (dispatcherThread.joinable()) {
+        dispatcherThread.join();
+    }
+    if (executor) {
+        executor->waitForIdle();
     }
     
-    globalLogger->logEvent("All jobs completed!");
+    currentLogger()->logEvent("All jobs completed!");
 }
 
 double Scheduler::getAverageWaitingTime() const {
+    ProfiledLockGuard lock(schedulerMutex);
     if (completedJobs == 0) return 0.0;
     return totalWaitingTime / completedJobs;
 }
 
 double Scheduler::getAverageTurnaroundTime() const {
+    ProfiledLockGuard lock(schedulerMutex);
     if (completedJobs == 0) return 0.0;
     return (totalWaitingTime + totalExecutionTime) / completedJobs;
 }
 
 double Scheduler::getThroughput() const {
+    ProfiledLockGuard lock(schedulerMutex);
     if (totalExecutionTime == 0) return 0.0;
     return completedJobs / totalExecutionTime;
 }
 
+const LatencyHistogram& Scheduler::getLatencyHistogram(LatencyMetric metric,
+                                                       JobPriority priority) const {
+    return latency[static_cast<int>(metric)][static_cast<int>(priority) - 1];
+}
+
+void Scheduler::mergeLatencyHistograms(LatencyMetric metric, LatencyHistogram& out) const {
+    for (int p = 0; p < 3; p++) {
+        out.merge(latency[static_cast<int>(metric)][p]);
+    }
+}
+
+void Scheduler::registerMetrics(MetricsRegistry& registry) {
+    registry.addCounterFunction("datacenter_jobs_submitted_total",
+        "Jobs added to the scheduler", "",
+        [this]() { return static_cast<double>(totalJobs.load()); });
+    registry.addCounterFunction("datacenter_jobs_completed_total",
+        "Jobs that finished and released their resources", "",
+        [this]() { return static_cast<double>(completedJobs.load()); });
+    registry.addCounterFunction("datacenter_jobs_backfilled_total",
+        "Jobs started ahead of a blocked head job", "",
+        [this]() { return static_cast<double>(getBackfilledJobs()); });
+    registry.addGaugeFunction("datacenter_jobs_in_system",
+        "Jobs submitted and not yet completed", "",
+        [this]() { return static_cast<double>(totalJobs.load() - completedJobs.load()); });
+    
+    static const char* metricNames[3] = {"datacenter_job_wait_seconds",
+                                         "datacenter_job_execution_seconds",
+                                         "datacenter_job_turnaround_seconds"};
+    static const char* metricHelp[3] = {"Time from arrival to start",
+                                        "Time from start to completion",
+                                        "Time from arrival to completion"};
+    static const char* priorityLabels[3] = {"priority=\"high\"", "priority=\"medium\"",
+                                            "priority=\"low\""};
+    for (int m = 0; m < 3; m++) {
+        for (int p = 0; p < 3; p++) {
+            registry.addHistogram(metricNames[m], metricHelp[m], priorityLabels[p], &latency[m][p]);
+        }
+    }
+}
+
+static void writeLatencyRow(std::stringstream& ss, const char* label, const LatencyHistogram& histogram) {
+    ss << label << std::setw(9) << histogram.getCount()
+       << std::setw(12) << histogram.getPercentile(50)
+       << std::setw(12) << histogram.getPercentile(95)
+       << std::setw(12) << histogram.getPercentile(99)
+       << std::setw(12) << histogram.getPercentile(99.9)
+       << std::setw(12) << histogram.getMax() << "\n";
+}
+
 std::string Scheduler::getSchedulingReport() const {
     std::stringstream ss;
     ss << std::fixed << std::setprecision(2);
     
     ss << "\n========== SCHEDULING REPORT ==========\n";
-    ss << "Algorithm: Priority Scheduling\n";
+    ss << "Algorithm: " << getSchedulingPolicyName() << "\n";
+    if (backfillDepth > 0) {
+        ss << "Backfill: EASY (depth " << backfillDepth << "), "
+           << getBackfilledJobs() << " jobs started early\n";
+    }
     ss << "Total Jobs: " << totalJobs << "\n";
     ss << "Completed Jobs: " << completedJobs << "\n";
     ss << "Average Waiting Time: " << getAverageWaitingTime() << " seconds\n";
     ss << "Average Turnaround Time: " << getAverageTurnaroundTime() << " seconds\n";
     ss << "Throughput: " << getThroughput() << " jobs/second\n";
+    
+    // Tail latency per metric, all jobs then by priority (classes with
+    // no completed jobs are left out)
+    static const char* metricNames[3] = {"Waiting", "Execution", "Turnaround"};
+    static const char* priorityLabels[3] = {"  HIGH  ", "  MEDIUM", "  LOW   "};
+    ss << "\nLatency Percentiles (seconds):\n";
+    ss << "             jobs         p50         p95         p99       p99.9         max\n";
+    for (int m = 0; m < 3; m++) {
+        LatencyMetric metric = static_cast<LatencyMetric>(m);
+        LatencyHistogram all;
+        mergeLatencyHistograms(metric, all);
+        ss << metricNames[m] << "\n";
+        writeLatencyRow(ss, "  ALL   ", all);
+        for (int p = 0; p < 3; p++) {
+            if (latency[m][p].getCount() > 0) {
+                writeLatencyRow(ss, priorityLabels[p], latency[m][p]);
+            }
+        }
+    }
     ss << "=======================================\n";
     
     return ss.str();
@@ -0,0 +1,237 @@
+// ============================================
+// FILE: scheduling_policy.cpp
+// DESCRIPTION: Implementation of the ready-queue policies
+// ============================================
+
+#include "../include/scheduling_policy.hpp"
+#include <algorithm>
+
+// ==================== PRIORITY ====================
+
+Job* PriorityPolicy::peek() {
+    return readyQueue.empty() ? nullptr : readyQueue.top();
+}
+
+Job* PriorityPolicy::pop() {
+    if (readyQueue.empty()) return nullptr;
+    Job* job = readyQueue.top();
+    readyQueue.pop();
+    return job;
+}
+
+Job* PriorityPolicy::removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) {
+    Job* taken = nullptr;
+    readyQueue.removeFirst(limit, [&](Job* job) {
+        if (!accept(job)) return false;
+        taken = job;
+        return true;
+    });
+    return taken;
+}
+
+// ==================== FCFS ====================
+
+Job* FCFSPolicy::peek() {
+    return readyQueue.empty() ? nullptr : readyQueue.front();
+}
+
+Job* FCFSPolicy::pop() {
+    if (readyQueue.empty()) return nullptr;
+    Job* job = readyQueue.front();
+    readyQueue.pop_front();
+    return job;
+}
+
+Job* FCFSPolicy::removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) {
+    size_t end = std::min(limit, readyQueue.size());
+    for (size_t i = 0; i < end; i++) {
+        Job* job = readyQueue[i];
+        if (accept(job)) {
+            readyQueue.erase(readyQueue.begin() + i);
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+// ==================== SJF ====================
+
+void SJFPolicy::push(Job* job) {
+    readyQueue.push({job->getEstimatedRuntimeMs(), nextSequence++, job});
+}
+
+Job* SJFPolicy::peek() {
+    return readyQueue.empty() ? nullptr : readyQueue.top().job;
+}
+
+Job* SJFPolicy::pop() {
+    if (readyQueue.empty()) return nullptr;
+    Job* job = readyQueue.top().job;
+    readyQueue.pop();
+    return job;
+}
+
+Job* SJFPolicy::removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) {
+    Job* taken = nullptr;
+    readyQueue.removeFirst(limit, [&](const Entry& entry) {
+        if (!accept(entry.job)) return false;
+        taken = entry.job;
+        return true;
+    });
+    return taken;
+}
+
+// ==================== ROUND ROBIN ====================
+
+int RoundRobinPolicy::nextClass() const {
+    for (int k = 0; k < CLASSES; k++) {
+        int c = (turn + k) % CLASSES;
+        if (!classQueues[c].empty()) return c;
+    }
+    return -1;
+}
+
+void RoundRobinPolicy::push(Job* job) {
+    int c = static_cast<int>(job->getPriority()) - 1;
+    classQueues[c].push_back(job);
+    count++;
+}
+
+Job* RoundRobinPolicy::peek() {
+    int c = nextClass();
+    return (c < 0) ? nullptr : classQueues[c].front();
+}
+
+Job* RoundRobinPolicy::pop() {
+    int c = nextClass();
+    if (c < 0) return nullptr;
+
+    Job* job = classQueues[c].front();
+    classQueues[c].pop_front();
+    count--;
+
+    // The next dispatch starts with the following class
+    turn = (c + 1) % CLASSES;
+    return job;
+}
+
+Job* RoundRobinPolicy::removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) {
+    // Replays the turn order pop() would follow, without popping
+    size_t position[CLASSES] = {0, 0, 0};
+    int t = turn;
+    for (size_t visited = 0; visited < limit && visited < count; visited++) {
+        int c = -1;
+        for (int k = 0; k < CLASSES && c < 0; k++) {
+            int candidate = (t + k) % CLASSES;
+            if (position[candidate] < classQueues[candidate].size()) c = candidate;
+        }
+        
+        Job* job = classQueues[c][position[c]];
+        if (accept(job)) {
+            classQueues[c].erase(classQueues[c].begin() + position[c]);
+            count--;
+            return job;
+        }
+        position[c]++;
+        t = (c + 1) % CLASSES;
+    }
+    return nullptr;
+}
+
+// ==================== MLFQ ====================
+
+// Estimated runtimes span roughly 2.9 s to 7.3 s
+const int MLFQPolicy::QUANTUM_MS[MLFQPolicy::LEVELS] = {4000, 5500, 0};
+
+int MLFQPolicy::levelFor(const Job* job) const {
+    int runtimeMs = job->getEstimatedRuntimeMs();
+    for (int level = 0; level < LEVELS - 1; level++) {
+        if (runtimeMs <= QUANTUM_MS[level]) return level;
+    }
+    return LEVELS - 1;
+}
+
+int MLFQPolicy::topLevel() const {
+    for (int level = 0; level < LEVELS; level++) {
+        if (!levels[level].empty()) return level;
+    }
+    return -1;
+}
+
+void MLFQPolicy::boost() {
+    for (int level = 1; level < LEVELS; level++) {
+        levels[0].splice(levels[0].end(), levels[level]);
+    }
+    dispatchesSinceBoost = 0;
+}
+
+void MLFQPolicy::push(Job* job) {
+    levels[levelFor(job)].push_back(job);
+    count++;
+}
+
+Job* MLFQPolicy::peek() {
+    int level = topLevel();
+    return (level < 0) ? nullptr : levels[level].front();
+}
+
+Job* MLFQPolicy::pop() {
+    int level = topLevel();
+    if (level < 0) return nullptr;
+
+    Job* job = levels[level].front();
+    levels[level].pop_front();
+    count--;
+
+    if (++dispatchesSinceBoost >= BOOST_INTERVAL) {
+        boost();
+    }
+    return job;
+}
+
+void MLFQPolicy::requeueRefused(Job* job) {
+    levels[LEVELS - 1].push_back(job);
+    count++;
+}
+
+Job* MLFQPolicy::removeFirstAccepted(size_t limit, const std::function<bool(Job*)>& accept) {
+    size_t visited = 0;
+    for (int level = 0; level < LEVELS; level++) {
+        for (auto it = levels[level].begin(); it != levels[level].end(); ++it) {
+            if (visited++ == limit) return nullptr;
+            Job* job = *it;
+            if (!accept(job)) continue;
+            
+            levels[level].erase(it);
+            count--;
+            if (++dispatchesSinceBoost >= BOOST_INTERVAL) {
+                boost();
+            }
+            return job;
+        }
+    }
+    return nullptr;
+}
+
+// ==================== FACTORY ====================
+
+SchedulingPolicy* createSchedulingPolicy(SchedulingAlgorithm algorithm) {
+    switch (algorithm) {
+        case SchedulingAlgorithm::FCFS: return new FCFSPolicy();
+        case SchedulingAlgorithm::SJF: return new SJFPolicy();
+        case SchedulingAlgorithm::ROUND_ROBIN: return new RoundRobinPolicy();
+        case SchedulingAlgorithm::MLFQ: return new MLFQPolicy();
+        case SchedulingAlgorithm::PRIORITY:
+        default: return new PriorityPolicy();
+    }
+}
+
+bool parseSchedulingAlgorithm(const std::string& name, SchedulingAlgorithm& algorithm) {
+    if (name == "priority") algorithm = SchedulingAlgorithm::PRIORITY;
+    else if (name == "fcfs") algorithm = SchedulingAlgorithm::FCFS;
+    else if (name == "sjf") algorithm = SchedulingAlgorithm::SJF;
+    else if (name == "rr") algorithm = SchedulingAlgorithm::ROUND_ROBIN;
+    else if (name == "mlfq") algorithm = SchedulingAlgorithm::MLFQ;
+    else return false;
+    return true;
+}
@@ -0,0 +1,380 @@
+// ============================================
+// FILE: simulation_runner.cpp
+// DESCRIPTION: Implementation of headless runs, parameter sweeps and
+//              Monte Carlo replications
+// ============================================
+
+#include "../include/simulation_runner.hpp"
+#include "../include/event_simulator.hpp"
+#include "../include/logger.hpp"
+#include <fstream>
+#include <iomanip>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <cmath>
+#include <functional>
+#include <algorithm>
+
+// Random jobs in a run that does not say how many
+static const int DEFAULT_SIMULATION_JOBS = 1000;
+
+static bool parseInt(const std::string& value, int minimum, int& out) {
+    char* end;
+    long parsed = std::strtol(value.c_str(), &end, 10);
+    if (value.empty() || *end != '\0' || parsed < minimum || parsed > 1000000000L) return false;
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+static bool parseDouble(const std::string& value, double& out) {
+    char* end;
+    double parsed = std::strtod(value.c_str(), &end);
+    if (value.empty() || *end != '\0' || parsed < 0) return false;
+    out = parsed;
+    return true;
+}
+
+static bool parseBool(const std::string& value, bool& out) {
+    if (value == "1" || value == "true" || value == "yes" || value == "on") out = true;
+    else if (value == "0" || value == "false" || value == "no" || value == "off") out = false;
+    else return false;
+    return true;
+}
+
+bool applySetting(SimulationConfig& config, const std::string& key, const std::string& value) {
+    if (key == "trace") {
+        config.tracePath = value;
+        return true;
+    }
+    if (key == "lock-free") return parseBool(value, config.lockFree);
+    if (key == "cpu") return parseInt(value, 1, config.capacity.cpuCores);
+    if (key == "ram") return parseInt(value, 1, config.capacity.ramGB);
+    if (key == "disk") return parseInt(value, 1, config.capacity.diskSlots);
+    if (key == "network") return parseInt(value, 1, config.capacity.networkSlots);
+    if (key == "nodes") return parseInt(value, 0, config.numNodes);
+    if (key == "placement") {
+        if (value == "first") config.placement = PlacementPolicy::FIRST_FIT;
+        else if (value == "next") config.placement = PlacementPolicy::NEXT_FIT;
+        else if (value == "best") config.placement = PlacementPolicy::BEST_FIT;
+        else return false;
+        return true;
+    }
+    if (key == "policy") return parseSchedulingAlgorithm(value, config.algorithm);
+    if (key == "backfill") return parseInt(value, 0, config.backfillDepth);
+    if (key == "arrivals") return parseArrivalProcess(value, config.arrivals);
+    if (key == "rate") return parseDouble(value, config.arrivalRate);
+    if (key == "swf") {
+        config.swfPath = value;
+        return true;
+    }
+    if (key == "time-scale") {
+        double scale;
+        if (!parseDouble(value, scale) || scale <= 0) return false;
+        config.timeScale = scale;
+        return true;
+    }
+    if (key == "jobs") return parseInt(value, 0, config.numJobs);
+    if (key == "seed") {
+        char* end;
+        unsigned long seed = std::strtoul(value.c_str(), &end, 10);
+        if (value.empty() || *end != '\0') return false;
+        config.seed = static_cast<unsigned int>(seed);
+        return true;
+    }
+    return false;
+}
+
+static std::string trim(const std::string& text) {
+    size_t first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) return "";
+    size_t last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
+}
+
+bool loadConfigFile(const std::string& path,
+                    std::vector<std::pair<std::string, std::string>>& settings) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        // "key = value", "key value" or a bare key for a switch
+        size_t split = line.find_first_of("= \t");
+        std::string key = trim(line.substr(0, split));
+        std::string value;
+        if (split != std::string::npos) {
+            value = trim(line.substr(split + 1));
+            if (!value.empty() && value[0] == '=') value = trim(value.substr(1));
+        }
+        settings.push_back({key, value.empty() ? "1" : value});
+    }
+    return true;
+}
+
+Scheduler* createScheduler(const SimulationConfig& config, ResourceManager* rm,
+                           DeadlockManager* dm, Cluster*& cluster) {
+    // Every node gets the single-box capacity
+    Scheduler* scheduler;
+    if (config.numNodes > 0) {
+        cluster = new Cluster(config.numNodes, rm->getTotalResources(), config.placement);
+        scheduler = new Scheduler(cluster);
+    } else {
+        cluster = nullptr;
+        scheduler = new Scheduler(rm, dm);
+    }
+    scheduler->setSchedulingPolicy(config.algorithm);
+    scheduler->setBackfill(config.backfillDepth > 0, config.backfillDepth);
+    return scheduler;
+}
+
+JobSource* createJobSource(const SimulationConfig& config, int numJobs,
+                           DeadlockManager* dm, SwfJobSource*& trace) {
+    trace = nullptr;
+    if (!config.swfPath.empty()) {
+        // Every cluster node has the single-box capacity, so one limit fits all
+        trace = new SwfJobSource(dm->getLargestAdmissible(), config.timeScale, numJobs);
+        if (!trace->open(config.swfPath)) {
+            delete trace;
+            trace = nullptr;
+            return nullptr;
+        }
+        return trace;
+    }
+
+    // A process without a rate runs at the default 10 jobs/s
+    RandomJobSource* source;
+    if (config.arrivals != ArrivalProcess::CONSTANT || config.arrivalRate > 0) {
+        double rate = (config.arrivalRate > 0) ? config.arrivalRate : 10.0;
+        source = new RandomJobSource(numJobs, config.seed, config.arrivals, rate);
+    } else {
+        source = new RandomJobSource(numJobs, config.seed);
+    }
+
+    // A small capacity must not leave jobs that can never be admitted
+    source->setRequestLimit(dm->getLargestAdmissible());
+    return source;
+}
+
+bool runSimulation(const SimulationConfig& config, SimulationResult& result) {
+    // Declared first so everything below logs through it until destroyed
+    Logger logger(LoggerOutput::DETACHED);
+    ThreadLoggerScope loggerScope(&logger);
+    if (!config.tracePath.empty() && !logger.openTrace(config.tracePath)) {
+        return false;
+    }
+
+    ResourceManager resourceManager(config.capacity.cpuCores, config.capacity.ramGB,
+                                    config.capacity.diskSlots, config.capacity.networkSlots,
+                                    config.lockFree);
+    DeadlockManager deadlockManager(&resourceManager);
+
+    int numJobs = config.numJobs;
+    if (numJobs <= 0 && config.swfPath.empty()) {
+        numJobs = DEFAULT_SIMULATION_JOBS;
+    }
+
+    SwfJobSource* trace;
+    JobSource* source = createJobSource(config, numJobs, &deadlockManager, trace);
+    if (!source) return false;
+
+    Cluster* cluster;
+    Scheduler* scheduler = createScheduler(config, &resourceManager, &deadlockManager, cluster);
+    scheduler->setRetainCompletedJobs(false);
+
+    EventSimulator* simulator = cluster
+        ? new EventSimulator(cluster, scheduler, source, config.seed)
+        : new EventSimulator(&resourceManager, &deadlockManager, scheduler, source, config.seed);
+
+    auto startTime = std::chrono::steady_clock::now();
+    simulator->run();
+    auto endTime = std::chrono::steady_clock::now();
+
+    result.totalJobs = scheduler->getTotalJobs();
+    result.completedJobs = scheduler->getCompletedJobs();
+    result.averageWaitingTime = scheduler->getAverageWaitingTime();
+    result.averageTurnaroundTime = scheduler->getAverageTurnaroundTime();
+    result.makespan = simulator->getSimulatedTime();
+    result.throughput = (result.makespan > 0) ? result.completedJobs / result.makespan : 0.0;
+    result.deadlocksPrevented = cluster ? cluster->getDeadlocksPrevented()
+                                        : deadlockManager.getDeadlocksPrevented();
+    result.backfilledJobs = scheduler->getBackfilledJobs();
+    for (size_t r = 0; r < 4; r++) {
+        result.utilization[r] = simulator->getAverageUtilization(r);
+    }
+    result.wallSeconds = std::chrono::duration<double>(endTime - startTime).count();
+
+    delete simulator;
+    delete scheduler;
+    delete cluster;
+    delete source;
+    return true;
+}
+
+static void writeSweepRow(std::ostream& out, const SweepPoint& point, bool ok,
+                          const SimulationResult& result) {
+    for (const std::string& setting : point.settings) {
+        out << setting << ',';
+    }
+    if (!ok) {
+        out << "failed,,,,,,,,,,,,,\n";
+        return;
+    }
+    out << "ok," << result.totalJobs << ',' << result.completedJobs << ','
+        << std::fixed << std::setprecision(2)
+        << result.averageWaitingTime << ',' << result.averageTurnaroundTime << ','
+        << result.makespan << ',' << std::setprecision(6) << result.throughput << ','
+        << result.deadlocksPrevented << ',' << result.backfilledJobs << ','
+        << std::setprecision(2) << result.utilization[0] << ',' << result.utilization[1] << ','
+        << result.utilization[2] << ',' << result.utilization[3] << ','
+        << std::setprecision(3) << result.wallSeconds << '\n';
+}
+
+// Calls run(index) for every index in [0, count) on up to threads worker
+// threads (0 = one per hardware thread), handing out indices in order
+static void parallelFor(size_t count, unsigned int threads,
+                        const std::function<void(size_t)>& run) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    threads = static_cast<unsigned int>(std::min<size_t>(threads, count));
+
+    std::atomic<size_t> nextIndex(0);
+    auto worker = [&]() {
+        while (true) {
+            size_t index = nextIndex.fetch_add(1);
+            if (index >= count) return;
+            run(index);
+        }
+    };
+
+    std::vector<std::thread> workers;
+    for (unsigned int i = 0; i < threads; i++) {
+        workers.emplace_back(worker);
+    }
+    for (auto& thread : workers) {
+        thread.join();
+    }
+}
+
+void runSweep(const std::vector<std::string>& columns, const std::vector<SweepPoint>& points,
+              unsigned int threads, std::ostream& out) {
+    for (const std::string& column : columns) {
+        out << column << ',';
+    }
+    out << "status,total_jobs,completed_jobs,avg_wait_s,avg_turnaround_s,makespan_s,"
+           "throughput_jobs_per_s,deadlocks_prevented,backfilled_jobs,"
+           "cpu_util_pct,ram_util_pct,disk_util_pct,network_util_pct,wall_s\n";
+    out.flush();
+
+    // Points run in grid order; each row is written as soon as every
+    // earlier row has been, so the output is in grid order too
+    std::vector<SimulationResult> results(points.size());
+    std::vector<char> finished(points.size(), 0);
+    std::vector<char> succeeded(points.size(), 0);
+    std::mutex outputMutex;
+    size_t written = 0;
+
+    parallelFor(points.size(), threads, [&](size_t index) {
+        bool ok = runSimulation(points[index].config, results[index]);
+
+        std::lock_guard<std::mutex> lock(outputMutex);
+        finished[index] = 1;
+        succeeded[index] = ok;
+        while (written < points.size() && finished[written]) {
+            writeSweepRow(out, points[written], succeeded[written], results[written]);
+            written++;
+        }
+        out.flush();
+    });
+}
+
+// Two-sided 95% quantiles of Student's t for 1-30 degrees of freedom
+static const double T_QUANTILES_95[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+// Beyond the table, the quantile at the bracket's lower end, which keeps
+// the interval conservative
+static double tQuantile95(size_t degrees) {
+    if (degrees <= 30) return T_QUANTILES_95[degrees - 1];
+    if (degrees <= 40) return 2.042;
+    if (degrees <= 60) return 2.021;
+    if (degrees <= 120) return 2.000;
+    return 1.980;
+}
+
+Estimate estimateMean(const std::vector<double>& samples) {
+    Estimate estimate = {0.0, 0.0};
+    size_t n = samples.size();
+    if (n == 0) return estimate;
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    estimate.mean = sum / n;
+    if (n < 2) return estimate;
+
+    double squares = 0;
+    for (double sample : samples) {
+        squares += (sample - estimate.mean) * (sample - estimate.mean);
+    }
+    double standardError = std::sqrt(squares / (n - 1) / n);
+    estimate.halfWidth = tQuantile95(n - 1) * standardError;
+    return estimate;
+}
+
+bool runReplications(const SimulationConfig& config, int replications,
+                     unsigned int threads, ReplicationSummary& summary) {
+    if (replications <= 0) return false;
+
+    std::vector<SimulationResult> results(replications);
+    std::vector<char> succeeded(replications, 0);
+
+    auto startTime = std::chrono::steady_clock::now();
+    parallelFor(replications, threads, [&](size_t index) {
+        SimulationConfig replica = config;
+        replica.seed = config.seed + static_cast<unsigned int>(index);
+        succeeded[index] = runSimulation(replica, results[index]);
+    });
+    auto endTime = std::chrono::steady_clock::now();
+
+    for (char ok : succeeded) {
+        if (!ok) return false;
+    }
+
+    // Aggregated in seed order, so the sums do not depend on which thread
+    // finished first
+    auto collect = [&](double SimulationResult::*field) {
+        std::vector<double> samples;
+        for (const SimulationResult& result : results) {
+            samples.push_back(result.*field);
+        }
+        return estimateMean(samples);
+    };
+
+    summary.replications = replications;
+    summary.averageWaitingTime = collect(&SimulationResult::averageWaitingTime);
+    summary.averageTurnaroundTime = collect(&SimulationResult::averageTurnaroundTime);
+    summary.makespan = collect(&SimulationResult::makespan);
+    summary.throughput = collect(&SimulationResult::throughput);
+    for (size_t r = 0; r < 4; r++) {
+        std::vector<double> samples;
+        for (const SimulationResult& result : results) {
+            samples.push_back(result.utilization[r]);
+        }
+        summary.utilization[r] = estimateMean(samples);
+    }
+    summary.wallSeconds = std::chrono::duration<double>(endTime - startTime).count();
+    return true;
+}
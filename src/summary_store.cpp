@@ -0,0 +1,259 @@
+// ============================================
+// FILE: summary_store.cpp
+// DESCRIPTION: Implementation of the segmented job summary store
+// ============================================
+
+#include "../include/summary_store.hpp"
+#include <iostream>
+#include <cstdio>
+#include <vector>
+#include <algorithm>
+
+static bool fileExists(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return false;
+    std::fclose(file);
+    return true;
+}
+
+static uint64_t fileSize(const std::string& path) {
+    std::FILE* file = std::fopen(path.c_str(), "rb");
+    if (file == nullptr) return 0;
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fclose(file);
+    return size > 0 ? static_cast<uint64_t>(size) : 0;
+}
+
+JobSummaryStore::JobSummaryStore(const std::string& dir, bool readOnlyMode, uint64_t maxSegment)
+    : directory(dir), readOnly(readOnlyMode), opened(false), maxSegmentBytes(maxSegment),
+      segmentFile(nullptr), indexFile(nullptr), currentSegment(0), segmentOffset(0) {
+
+    // Find the newest segment; appends continue there
+    while (fileExists(segmentPath(currentSegment + 1))) {
+        currentSegment++;
+    }
+
+    // Without an index every record is re-indexed; with one, only those
+    // written after its last good entry
+    bool hadIndex = fileExists(indexPath());
+    uint32_t resumeSegment = 0;
+    uint64_t resumeOffset = 0;
+    bool indexIntact = hadIndex && loadIndex(resumeSegment, resumeOffset);
+
+    bool tornTail = false;
+    size_t recovered = scanSegments(resumeSegment, resumeOffset, tornTail);
+    bool rewriteIndex = !indexIntact || recovered > 0;
+
+    if (readOnly) {
+        opened = hadIndex || fileExists(segmentPath(0));
+        return;
+    }
+
+    // A repaired index is written out in full, then appended to
+    indexFile = std::fopen(indexPath().c_str(), rewriteIndex ? "wb" : "ab");
+    if (indexFile == nullptr) {
+        std::cerr << "Error: Could not open " << indexPath() << std::endl;
+        return;
+    }
+    if (rewriteIndex) {
+        // In record order, like an index that was only ever appended to
+        std::vector<SummaryIndexEntry> entries;
+        for (int jobId : jobOrder) {
+            entries.push_back(index[jobId]);
+        }
+        std::sort(entries.begin(), entries.end(),
+            [](const SummaryIndexEntry& a, const SummaryIndexEntry& b) {
+                return a.segment != b.segment ? a.segment < b.segment : a.offset < b.offset;
+            });
+        std::fwrite(entries.data(), sizeof(SummaryIndexEntry), entries.size(), indexFile);
+        std::fflush(indexFile);
+    }
+
+    opened = openSegment(tornTail ? currentSegment + 1 : currentSegment);
+}
+
+JobSummaryStore::~JobSummaryStore() {
+    if (segmentFile != nullptr) std::fclose(segmentFile);
+    if (indexFile != nullptr) std::fclose(indexFile);
+}
+
+std::string JobSummaryStore::segmentPath(uint32_t segment) const {
+    char name[48];
+    std::snprintf(name, sizeof(name), "/job_summaries.%04u.seg", segment);
+    return directory + name;
+}
+
+std::string JobSummaryStore::indexPath() const {
+    return directory + "/job_summaries.idx";
+}
+
+bool JobSummaryStore::openSegment(uint32_t segment) {
+    if (segmentFile != nullptr) {
+        std::fclose(segmentFile);
+    }
+
+    segmentFile = std::fopen(segmentPath(segment).c_str(), "ab");
+    if (segmentFile == nullptr) {
+        std::cerr << "Error: Could not open " << segmentPath(segment) << std::endl;
+        return false;
+    }
+
+    std::fseek(segmentFile, 0, SEEK_END);
+    currentSegment = segment;
+    segmentOffset = static_cast<uint64_t>(std::ftell(segmentFile));
+    return true;
+}
+
+void JobSummaryStore::addToIndex(const SummaryIndexEntry& entry) {
+    auto it = index.find(entry.jobId);
+    if (it == index.end()) {
+        jobOrder.push_back(entry.jobId);
+        index.emplace(entry.jobId, entry);
+    } else {
+        it->second = entry;
+    }
+}
+
+bool JobSummaryStore::loadIndex(uint32_t& segment, uint64_t& offset) {
+    std::FILE* file = std::fopen(indexPath().c_str(), "rb");
+    if (file == nullptr) return false;
+
+    std::vector<uint64_t> segmentSizes;
+    for (uint32_t s = 0; s <= currentSegment; s++) {
+        segmentSizes.push_back(fileSize(segmentPath(s)));
+    }
+
+    // Entries are in append order, so the first one past its segment's
+    // end marks where the index stops being trustworthy. A torn trailing
+    // entry (crash mid-write) is simply not read.
+    bool intact = true;
+    SummaryIndexEntry entry;
+    while (std::fread(&entry, sizeof(entry), 1, file) == 1) {
+        if (entry.segment > currentSegment || entry.offset < sizeof(SummaryRecordHeader) ||
+            entry.offset + entry.length > segmentSizes[entry.segment]) {
+            intact = false;
+            break;
+        }
+        addToIndex(entry);
+        uint64_t end = entry.offset + entry.length;
+        if (entry.segment > segment || (entry.segment == segment && end > offset)) {
+            segment = entry.segment;
+            offset = end;
+        }
+    }
+    std::fclose(file);
+    return intact;
+}
+
+size_t JobSummaryStore::scanSegments(uint32_t segment, uint64_t offset, bool& tornTail) {
+    size_t indexed = 0;
+    for (; segment <= currentSegment; segment++, offset = 0) {
+        std::FILE* file = std::fopen(segmentPath(segment).c_str(), "rb");
+        if (file == nullptr) continue;
+        std::fseek(file, 0, SEEK_END);
+        uint64_t size = static_cast<uint64_t>(std::ftell(file));
+
+        // Walk the record headers; a record whose text runs past the end
+        // of the file was torn by a crash and ends the segment
+        SummaryRecordHeader header;
+        while (offset < size) {
+            if (std::fseek(file, static_cast<long>(offset), SEEK_SET) != 0 ||
+                std::fread(&header, sizeof(header), 1, file) != 1 ||
+                header.magic != RECORD_MAGIC ||
+                offset + sizeof(header) + header.length > size) {
+                if (segment == currentSegment) tornTail = true;
+                break;
+            }
+            offset += sizeof(header);
+
+            SummaryIndexEntry entry;
+            entry.jobId = header.jobId;
+            entry.segment = segment;
+            entry.offset = offset;
+            entry.length = header.length;
+            entry.reserved = 0;
+            addToIndex(entry);
+            indexed++;
+
+            offset += header.length;
+        }
+        std::fclose(file);
+    }
+    return indexed;
+}
+
+bool JobSummaryStore::append(int jobId, const std::string& summary) {
+    std::lock_guard<std::mutex> lock(storeMutex);
+
+    if (segmentFile == nullptr || indexFile == nullptr) return false;
+
+    SummaryRecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.jobId = jobId;
+    header.length = static_cast<uint32_t>(summary.size());
+
+    uint64_t recordBytes = sizeof(header) + summary.size();
+    if (segmentOffset > 0 && segmentOffset + recordBytes > maxSegmentBytes) {
+        if (!openSegment(currentSegment + 1)) return false;
+    }
+
+    // The record reaches the file before its index entry does, so a
+    // crash never leaves an entry pointing at data that was not written
+    std::fwrite(&header, sizeof(header), 1, segmentFile);
+    std::fwrite(summary.data(), 1, summary.size(), segmentFile);
+    if (std::fflush(segmentFile) != 0) {
+        // Part of the record may be on disk; later records go to a fresh
+        // segment so they stay readable
+        openSegment(currentSegment + 1);
+        return false;
+    }
+
+    SummaryIndexEntry entry;
+    entry.jobId = jobId;
+    entry.segment = currentSegment;
+    entry.offset = segmentOffset + sizeof(header);
+    entry.length = header.length;
+    entry.reserved = 0;
+    segmentOffset += recordBytes;
+
+    std::fwrite(&entry, sizeof(entry), 1, indexFile);
+    addToIndex(entry);
+    return true;
+}
+
+bool JobSummaryStore::lookup(int jobId, std::string& summary) {
+    SummaryIndexEntry entry;
+    {
+        std::lock_guard<std::mutex> lock(storeMutex);
+
+        auto it = index.find(jobId);
+        if (it == index.end()) return false;
+        entry = it->second;
+    }
+
+    std::FILE* file = std::fopen(segmentPath(entry.segment).c_str(), "rb");
+    if (file == nullptr) return false;
+
+    summary.resize(entry.length);
+    bool ok = std::fseek(file, static_cast<long>(entry.offset), SEEK_SET) == 0 &&
+              std::fread(&summary[0], 1, entry.length, file) == entry.length;
+    std::fclose(file);
+    return ok;
+}
+
+std::vector<int> JobSummaryStore::getJobIds() {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return jobOrder;
+}
+
+size_t JobSummaryStore::size() {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    return index.size();
+}
+
+void JobSummaryStore::flush() {
+    std::lock_guard<std::mutex> lock(storeMutex);
+    if (segmentFile != nullptr) std::fflush(segmentFile);
+    if (indexFile != nullptr) std::fflush(indexFile);
+}
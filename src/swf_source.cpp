@@ -0,0 +1,136 @@
+// ============================================
+// FILE: swf_source.cpp
+// DESCRIPTION: Implementation of the SWF trace replay source
+// ============================================
+
+#include "../include/swf_source.hpp"
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <climits>
+#include <algorithm>
+
+static const int SWF_FIELDS = 18;
+
+// 1-based SWF field numbers
+static const int SWF_JOB_NUMBER = 1;
+static const int SWF_SUBMIT_TIME = 2;
+static const int SWF_RUN_TIME = 4;
+static const int SWF_ALLOCATED_PROCS = 5;
+static const int SWF_USED_MEMORY = 7;
+static const int SWF_REQUESTED_PROCS = 8;
+static const int SWF_REQUESTED_MEMORY = 10;
+static const int SWF_QUEUE = 15;
+
+SwfJobSource::SwfJobSource(const ResourceRequest& largestRequest, double scale, int jobLimit)
+    : offset(0), limit(largestRequest), timeScale(scale > 0 ? scale : 1.0),
+      maxJobs(jobLimit), produced(0), maxProcs(0), started(false),
+      firstSubmit(0), lastArrival(0), skipped(0), clamped(0) {
+}
+
+bool SwfJobSource::open(const std::string& path) {
+    return file.open(path.c_str());
+}
+
+bool SwfJobSource::nextLine() {
+    const char* data = reinterpret_cast<const char*>(file.getData());
+    size_t size = file.getSize();
+    if (offset >= size) return false;
+
+    const char* begin = data + offset;
+    const void* newline = std::memchr(begin, '\n', size - offset);
+    size_t length = newline ? static_cast<const char*>(newline) - begin : size - offset;
+
+    line.assign(begin, length);
+    size_t previous = offset;
+    offset += length + (newline ? 1 : 0);
+
+    if (offset / RELEASE_INTERVAL != previous / RELEASE_INTERVAL) {
+        file.release(offset);
+    }
+    return true;
+}
+
+void SwfJobSource::parseHeaderComment() {
+    // "; MaxProcs: 128" - only the machine size matters here
+    const char* key = std::strstr(line.c_str(), "MaxProcs:");
+    if (key) {
+        maxProcs = std::max(0, std::atoi(key + std::strlen("MaxProcs:")));
+    }
+}
+
+bool SwfJobSource::next(JobSpec& spec) {
+    if (maxJobs > 0 && produced >= maxJobs) return false;
+
+    while (nextLine()) {
+        size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos) continue;
+        if (line[first] == ';') {
+            if (!started) parseHeaderComment();
+            continue;
+        }
+
+        // Missing fields are -1 in SWF; a short line reads the same way
+        double fields[SWF_FIELDS + 1];
+        std::fill(fields, fields + SWF_FIELDS + 1, -1.0);
+        const char* cursor = line.c_str();
+        int count = 0;
+        while (count < SWF_FIELDS) {
+            char* end;
+            double value = std::strtod(cursor, &end);
+            if (end == cursor) break;
+            fields[++count] = value;
+            cursor = end;
+        }
+
+        double runTime = fields[SWF_RUN_TIME];
+        double procs = fields[SWF_ALLOCATED_PROCS] > 0 ? fields[SWF_ALLOCATED_PROCS]
+                                                       : fields[SWF_REQUESTED_PROCS];
+        if (count < SWF_ALLOCATED_PROCS || runTime <= 0 || procs <= 0) {
+            skipped++;
+            continue;
+        }
+
+        double submit = fields[SWF_SUBMIT_TIME];
+        if (!started) {
+            started = true;
+            firstSubmit = std::max(0.0, submit);
+        }
+        if (submit >= 0) {
+            // Traces are sorted by submit time; small reorderings are held
+            // back so arrivals stay non-decreasing
+            lastArrival = std::max(lastArrival, (submit - firstSubmit) / timeScale);
+        }
+
+        int cpu = static_cast<int>(std::ceil(maxProcs > 0 ? procs * limit.cpuCores / maxProcs : procs));
+
+        double memoryKB = fields[SWF_USED_MEMORY] > 0 ? fields[SWF_USED_MEMORY]
+                                                      : fields[SWF_REQUESTED_MEMORY];
+        int ram;
+        if (memoryKB > 0) {
+            ram = static_cast<int>(std::ceil(memoryKB * procs / (1024.0 * 1024.0)));
+        } else {
+            ram = static_cast<int>(std::ceil(static_cast<double>(cpu) * limit.ramGB / limit.cpuCores));
+        }
+
+        if (cpu > limit.cpuCores || ram > limit.ramGB) {
+            clamped++;
+        }
+        cpu = std::min(std::max(cpu, 1), limit.cpuCores);
+        ram = std::min(std::max(ram, 1), limit.ramGB);
+
+        double runtimeMs = runTime * 1000.0 / timeScale;
+
+        spec.id = fields[SWF_JOB_NUMBER] > 0 ? static_cast<int>(fields[SWF_JOB_NUMBER]) : produced + 1;
+        spec.priority = (fields[SWF_QUEUE] == 0) ? JobPriority::HIGH : JobPriority::MEDIUM;
+        spec.needs = ResourceRequest(cpu, ram, std::min(1, limit.diskSlots),
+                                     std::min(1, limit.networkSlots));
+        spec.arrivalTime = lastArrival;
+        spec.runtimeMs = static_cast<int>(std::min(std::max(runtimeMs, 1.0), static_cast<double>(INT_MAX)));
+
+        produced++;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,69 @@
+// ============================================
+// FILE: summary_dump.cpp
+// DESCRIPTION: CLI for reading the consolidated job summary store
+// ============================================
+
+#include "../../include/summary_store.hpp"
+#include <iostream>
+#include <string>
+#include <vector>
+#include <cstdlib>
+
+static void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [--dir <logs dir>] (--list | --all | <job id>...)\n";
+}
+
+int main(int argc, char* argv[]) {
+    std::string dir = "logs";
+    std::vector<std::string> args;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--dir" && i + 1 < argc) {
+            dir = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    if (args.empty()) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    JobSummaryStore store(dir, true);
+    if (!store.isOpen()) {
+        std::cerr << "Error: No job summary store in " << dir << "\n";
+        return 1;
+    }
+
+    if (args[0] == "--list") {
+        std::cout << store.size() << " job summaries\n";
+        for (int jobId : store.getJobIds()) {
+            std::cout << jobId << "\n";
+        }
+        return 0;
+    }
+
+    std::vector<int> jobIds;
+    if (args[0] == "--all") {
+        jobIds = store.getJobIds();
+    } else {
+        for (const std::string& arg : args) {
+            jobIds.push_back(std::atoi(arg.c_str()));
+        }
+    }
+
+    int missing = 0;
+    std::string summary;
+    for (int jobId : jobIds) {
+        if (store.lookup(jobId, summary)) {
+            std::cout << summary;
+        } else {
+            std::cerr << "Job " << jobId << ": no summary found\n";
+            missing++;
+        }
+    }
+
+    return missing == 0 ? 0 : 2;
+}
@@ -0,0 +1,121 @@
+// ============================================
+// FILE: workload.cpp
+// DESCRIPTION: Implementation of job arrival sources
+// ============================================
+
+#include "../include/workload.hpp"
+#include <algorithm>
+
+JobSpec makeRandomJobSpec(int id, std::mt19937& gen) {
+    std::uniform_int_distribution<> prioDist(1, 3);
+    JobPriority priority = static_cast<JobPriority>(prioDist(gen));
+
+    std::uniform_int_distribution<> cpuDist(1, 4);
+    std::uniform_int_distribution<> ramDist(2, 16);
+    std::uniform_int_distribution<> diskDist(1, 3);
+    std::uniform_int_distribution<> netDist(1, 2);
+
+    // System jobs get twice the CPU allocation
+    int cpuMultiplier = (priority == JobPriority::HIGH) ? 2 : 1;
+
+    JobSpec spec;
+    spec.id = id;
+    spec.priority = priority;
+    spec.needs = ResourceRequest(
+        cpuDist(gen) * cpuMultiplier,
+        ramDist(gen),
+        diskDist(gen),
+        netDist(gen)
+    );
+    spec.arrivalTime = 0.0;
+    spec.runtimeMs = 0;
+    return spec;
+}
+
+Job* createJob(const JobSpec& spec, ResourceManager* rm, DeadlockManager* dm) {
+    Job* job = new Job(spec.id, spec.priority, spec.needs, rm, dm);
+    if (spec.runtimeMs > 0) {
+        job->setFixedRuntimeMs(spec.runtimeMs);
+    }
+    return job;
+}
+
+bool parseArrivalProcess(const std::string& name, ArrivalProcess& process) {
+    if (name == "constant") process = ArrivalProcess::CONSTANT;
+    else if (name == "poisson") process = ArrivalProcess::POISSON;
+    else if (name == "mmpp") process = ArrivalProcess::MMPP;
+    else return false;
+    return true;
+}
+
+const char* getArrivalProcessName(ArrivalProcess process) {
+    switch (process) {
+        case ArrivalProcess::CONSTANT: return "Constant rate";
+        case ArrivalProcess::POISSON: return "Poisson";
+        case ArrivalProcess::MMPP: return "Bursty (MMPP)";
+        default: return "Unknown";
+    }
+}
+
+RandomJobSource::RandomJobSource(int numJobs, unsigned int seed, double interArrival)
+    : totalJobs(numJobs), generated(0), interArrivalTime(interArrival), gen(seed),
+      process(ArrivalProcess::CONSTANT), rate(1.0 / interArrival), arrivalGen(seed + 1),
+      clock(0), bursting(true), stateEnds(0), limited(false) {
+}
+
+RandomJobSource::RandomJobSource(int numJobs, unsigned int seed, ArrivalProcess arrivals,
+                                 double arrivalRate)
+    : totalJobs(numJobs), generated(0), interArrivalTime(1.0 / arrivalRate), gen(seed),
+      process(arrivals), rate(arrivalRate), arrivalGen(seed + 1),
+      clock(0), bursting(true), stateEnds(0), limited(false) {
+}
+
+void RandomJobSource::setRequestLimit(const ResourceRequest& largest) {
+    limited = true;
+    limit = largest;
+}
+
+double RandomJobSource::nextArrivalTime() {
+    if (process == ArrivalProcess::CONSTANT) {
+        return generated * interArrivalTime;
+    }
+
+    if (process == ArrivalProcess::POISSON) {
+        std::exponential_distribution<double> gap(rate);
+        clock += gap(arrivalGen);
+        return clock;
+    }
+
+    // MMPP: the lull rate is chosen so the two states average to rate.
+    // The run opens with a state change into a lull.
+    double lullRate = 2.0 * rate / (1 + MMPP_BURST_FACTOR);
+    std::exponential_distribution<double> dwell(rate / MMPP_DWELL_ARRIVALS);
+    while (true) {
+        double stateRate = bursting ? lullRate * MMPP_BURST_FACTOR : lullRate;
+        std::exponential_distribution<double> gap(stateRate);
+        double candidate = clock + gap(arrivalGen);
+        if (candidate < stateEnds) {
+            clock = candidate;
+            return clock;
+        }
+
+        // Memoryless: restart the draw from the state change
+        clock = stateEnds;
+        bursting = !bursting;
+        stateEnds = clock + dwell(arrivalGen);
+    }
+}
+
+bool RandomJobSource::next(JobSpec& spec) {
+    if (generated >= totalJobs) return false;
+
+    spec = makeRandomJobSpec(generated + 1, gen);
+    if (limited) {
+        for (size_t r = 0; r < ResourceRequest::DIMENSIONS; r++) {
+            spec.needs[r] = std::min(spec.needs[r], limit[r]);
+        }
+    }
+    spec.arrivalTime = nextArrivalTime();
+    generated++;
+    return true;
+}